@@ -0,0 +1,251 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSCIFIOBridgePool_h
+#define itkSCIFIOBridgePool_h
+
+#include "SCIFIOExport.h"
+
+#include "itksys/Process.h"
+
+#include <chrono>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class SCIFIOBridgeWorker
+ *
+ * \brief A running SCIFIOITKBridge Java process.
+ *
+ * Holds the kwsys process handle, the pipe used to feed commands to the
+ * bridge's stdin, and the bookkeeping needed by SCIFIOBridgePool.
+ *
+ * Except on Windows, the stdout and stderr pipes of the bridge are created
+ * here too, rather than by kwsys, so that SCIFIOBridgePool::WaitForData()
+ * can read the pixels straight into their destination, without going
+ * through the buffer of kwsys first. stderr is read from its own pipe
+ * whenever stdout has nothing to offer.
+ *
+ * Right after startup the bridge is asked which protocol extensions it
+ * understands (the "capabilities" command). Bridges that predate this
+ * negotiation end up with an empty capability set and are only spoken to
+ * with the original text protocol. The answer is remembered for the rest
+ * of the process, so the question is asked once per bridge. A bridge that
+ * does not answer within SCIFIOBridgePool::GetNegotiationTimeout() is
+ * replaced by one spoken to with the text protocol, and the question is
+ * asked again of the next new one. Known capabilities are:
+ *
+ * - "shm" - pixel data can be exchanged through a SCIFIOSharedMemory
+ *   segment instead of the stdout/stdin pipes. "readShm" fills the segment
+ *   with the region asked for. "writeShm" takes the segment and the
+ *   parameters of "write", and replies with the number of bytes per plane,
+ *   as "write" does; then each "plane" command takes the next plane from
+ *   the segment, and is acknowledged once it is written.
+ * - "streamWrite" - "writeStream" takes each plane as a single chunk
+ *   prefixed with its 64-bit little endian length, and acknowledges the
+ *   whole image once.
+ * - "resolutions" - "resolutionCount" returns the number of resolution
+ *   levels of the current series, and "resolution" selects the level that
+ *   "info" and the read commands refer to, reporting the sizes and spacing
+ *   of that level. Selecting a series goes back to level 0.
+ * - "seriesTable" - "seriesTable" replies with the core metadata of every
+ *   series of a file: the same key/value pairs as "info", restricted to
+ *   sizes, spacing, pixel type, RGBChannelCount, ResolutionCount and
+ *   SeriesName, each series starting with a "Series" key.
+ * - "metadataLevel" - "info" takes a metadata level after the file name:
+ *   "core" for the core fields only, "filtered" followed by the keys or
+ *   '*'-terminated key prefixes to send besides them, or "full".
+ * - "rawBytes" - "read" and "readShm" take a trailing "raw" field, after
+ *   which the pixels are shipped in the byte order of the file, as reported
+ *   by "info", rather than in the byte order of the host.
+ * - "nativeLayout" - "read" and "readShm" take a trailing "planar" field,
+ *   after which the channels of files that are not interleaved are shipped
+ *   as stored: for each plane of the region, its RGBChannelCount channels
+ *   one after the other.
+ * - "int64" - after the "int64" command, images of 64-bit integers are
+ *   reported with pixel types 9 (signed) and 10 (unsigned) and shipped as
+ *   such, rather than as doubles, and "write" takes those pixel types. The
+ *   pool sends the command right after the workers are spawned, and the
+ *   bridge acknowledges it with an "int64" line and a blank line. The
+ *   other pixel types are the constants of Bio-Formats' FormatTools, which
+ *   has none for 64-bit integers: 9 and 10 are the first values it leaves
+ *   free, reserved by this extension. The scifio-itk-bridge 1.2.1 that the
+ *   build downloads does not implement it.
+ * - "formats" - "formats" lists the supported suffixes and signatures, as
+ *   described in SCIFIOFormatRegistry.
+ * - "binary" - messages are framed as described in SCIFIOBridgeProtocol.
+ *   The pool switches such workers to binary framing right after they are
+ *   spawned, so BinaryFraming is set for the worker's whole lifetime.
+ *
+ * \ingroup SCIFIO
+ */
+class SCIFIO_EXPORT SCIFIOBridgeWorker
+{
+public:
+  using ClockType = std::chrono::steady_clock;
+
+  itksysProcess *           Process{ nullptr };
+  itksysProcess_Pipe_Handle Pipe[2];
+
+  /** Java command line this worker was spawned with, with the size of its
+   * -Xmx option left out. Workers are only handed out to callers asking
+   * for the very same command line, see SCIFIOBridgePool::Lease(). */
+  std::string CommandLine;
+
+  /** Heap size, in megabytes, given by the -Xmx option of the command
+   * line, or 0 if there is none or it is not in megabytes. */
+  unsigned long long HeapSize{ 0 };
+
+  /** Series last selected on the bridge side, or 0 if untouched. */
+  int Series{ 0 };
+
+  /** Resolution level last selected on the bridge side, or 0 if
+   * untouched. */
+  int Resolution{ 0 };
+
+  /** Protocol extensions negotiated with the bridge. */
+  std::set<std::string> Capabilities;
+
+  bool
+  HasCapability(const std::string & capability) const
+  {
+    return Capabilities.count(capability) > 0;
+  }
+
+  /** Whether commands and replies are exchanged as SCIFIOBridgeProtocol
+   * frames rather than text lines. */
+  bool BinaryFraming{ false };
+
+  /** Request id of the last framed command sent to the bridge. */
+  uint32_t LastRequestId{ 0 };
+
+  /** Output of the bridge read from the pipe but not consumed yet. */
+  std::string PendingOutput;
+
+  /** Read ends of the stdout and stderr pipes of the process, or -1 if
+   * kwsys handles them, as on Windows, or once they are closed. */
+  int OutputPipe{ -1 };
+  int ErrorPipe{ -1 };
+
+  /** Where WaitForData() reads to when not given a destination. */
+  std::vector<char> OutputBuffer;
+  std::vector<char> ErrorBuffer;
+
+  /** Seconds it took to start the process, until it answered the
+   * capability negotiation. Cleared by the first SCIFIOImageIO that leases
+   * it, once added to its SCIFIOBridgeStatistics. */
+  double SpawnSeconds{ 0.0 };
+
+  ClockType::time_point LastUsed;
+};
+
+/** \class SCIFIOBridgePool
+ *
+ * \brief Process-wide pool of SCIFIOITKBridge Java processes.
+ *
+ * Starting the JVM and loading the Bio-Formats bundle takes seconds, so
+ * SCIFIOImageIO instances lease a worker from this pool instead of
+ * spawning their own, and hand it back when they are done with it.
+ *
+ * Idle workers are kept alive up to GetMaximumNumberOfIdleWorkers() and
+ * for at most GetIdleTimeout() seconds. Expired workers are reaped lazily,
+ * whenever the pool is used. Every worker is health checked before being
+ * leased out; dead workers are discarded and replaced transparently.
+ *
+ * The defaults can be overridden with the SCIFIO_POOL_SIZE,
+ * SCIFIO_POOL_IDLE_TIMEOUT and SCIFIO_NEGOTIATION_TIMEOUT environment
+ * variables. Setting SCIFIO_BRIDGE_EXTENSIONS to 0 skips the capability
+ * negotiation and restricts all workers to the original text protocol.
+ *
+ * \ingroup SCIFIO
+ */
+class SCIFIO_EXPORT SCIFIOBridgePool
+{
+public:
+  /** Return a running worker for the given Java command line, reusing an
+   * idle one if possible. Idle workers whose command line only differs in
+   * a larger -Xmx, in megabytes, of at most maximumHeapSize are reused
+   * too, so that a change in the heap needed does not always mean a new
+   * JVM; the worker's HeapSize tells which one was handed out. The caller
+   * owns the worker until it is passed to Release() or Discard(). */
+  static SCIFIOBridgeWorker *
+  Lease(const std::vector<std::string> & args, unsigned long long maximumHeapSize = 0);
+
+  /** Give a worker back to the pool. Unhealthy workers, and workers in
+   * excess of the maximum number of idle workers, are terminated. */
+  static void
+  Release(SCIFIOBridgeWorker * worker);
+
+  /** Terminate a worker instead of returning it to the pool, e.g. when its
+   * pipes are in an unknown state after an error. */
+  static void
+  Discard(SCIFIOBridgeWorker * worker);
+
+  /** Check whether the worker's Java process is still running. */
+  static bool
+  IsHealthy(SCIFIOBridgeWorker * worker);
+
+  /** Same as itksysProcess_WaitForData() for the output of the worker:
+   * wait up to timeout seconds, or forever if timeout is null, for the
+   * bridge to write to stdout or stderr, and return
+   * itksysProcess_Pipe_STDOUT or itksysProcess_Pipe_STDERR with the bytes
+   * in data and length, itksysProcess_Pipe_Timeout, or
+   * itksysProcess_Pipe_None once the bridge closed both. If a destination
+   * is given, up to capacity bytes of stdout are read straight into it
+   * where the worker owns its pipes, and data then points to it. */
+  static int
+  WaitForData(SCIFIOBridgeWorker * worker,
+              char **              data,
+              int *                length,
+              double *             timeout,
+              char *               destination = nullptr,
+              size_t               capacity = 0);
+
+  /** Maximum number of idle workers kept alive. Zero disables pooling. */
+  static void
+  SetMaximumNumberOfIdleWorkers(unsigned int number);
+  static unsigned int
+  GetMaximumNumberOfIdleWorkers();
+
+  /** Number of seconds an idle worker is kept alive. */
+  static void
+  SetIdleTimeout(double seconds);
+  static double
+  GetIdleTimeout();
+
+  /** Number of seconds a newly started bridge, JVM startup included, is
+   * given to answer the capability negotiation before it is replaced by
+   * one spoken to with the text protocol. 10 by default. */
+  static void
+  SetNegotiationTimeout(double seconds);
+  static double
+  GetNegotiationTimeout();
+
+  /** Number of workers currently waiting in the pool. */
+  static unsigned int
+  GetNumberOfIdleWorkers();
+
+  /** Terminate all idle workers. */
+  static void
+  Clear();
+};
+} // end namespace itk
+
+#endif // itkSCIFIOBridgePool_h
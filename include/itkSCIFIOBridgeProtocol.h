@@ -0,0 +1,178 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSCIFIOBridgeProtocol_h
+#define itkSCIFIOBridgeProtocol_h
+
+#include "SCIFIOExport.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class SCIFIOBridgeField
+ *
+ * \brief A single typed value of a SCIFIOITKBridge command or reply.
+ *
+ * With the text protocol every field is a string, and is parsed on
+ * demand by the To*() accessors. With the binary protocol fields keep the
+ * type they were sent with.
+ *
+ * \ingroup SCIFIO
+ */
+class SCIFIO_EXPORT SCIFIOBridgeField
+{
+public:
+  enum class TypeEnum : uint8_t
+  {
+    String = 0,
+    Int64 = 1,
+    Double = 2,
+    Bool = 3
+  };
+
+  SCIFIOBridgeField(const std::string & value)
+    : m_Type(TypeEnum::String)
+    , m_String(value)
+  {}
+  SCIFIOBridgeField(const char * value)
+    : m_Type(TypeEnum::String)
+    , m_String(value)
+  {}
+  SCIFIOBridgeField(int value)
+    : m_Type(TypeEnum::Int64)
+    , m_Int64(value)
+  {}
+  SCIFIOBridgeField(long value)
+    : m_Type(TypeEnum::Int64)
+    , m_Int64(value)
+  {}
+  SCIFIOBridgeField(long long value)
+    : m_Type(TypeEnum::Int64)
+    , m_Int64(value)
+  {}
+  SCIFIOBridgeField(unsigned long value)
+    : m_Type(TypeEnum::Int64)
+    , m_Int64(static_cast<int64_t>(value))
+  {}
+  SCIFIOBridgeField(unsigned long long value)
+    : m_Type(TypeEnum::Int64)
+    , m_Int64(static_cast<int64_t>(value))
+  {}
+  SCIFIOBridgeField(double value)
+    : m_Type(TypeEnum::Double)
+    , m_Double(value)
+  {}
+  SCIFIOBridgeField(bool value)
+    : m_Type(TypeEnum::Bool)
+    , m_Bool(value)
+  {}
+
+  TypeEnum
+  GetType() const
+  {
+    return m_Type;
+  }
+
+  /** Convert the field to the requested type. String fields are parsed;
+   * an itk::ExceptionObject is thrown if that fails. */
+  std::string
+  ToString() const;
+  int64_t
+  ToInt64() const;
+  double
+  ToDouble() const;
+  bool
+  ToBool() const;
+
+private:
+  TypeEnum    m_Type;
+  std::string m_String;
+  int64_t     m_Int64{ 0 };
+  double      m_Double{ 0.0 };
+  bool        m_Bool{ false };
+};
+
+using SCIFIOBridgeFields = std::vector<SCIFIOBridgeField>;
+
+/** \class SCIFIOBridgeProtocol
+ *
+ * \brief Encoding of the messages exchanged with SCIFIOITKBridge.
+ *
+ * The original protocol is line based: a command is a tab-separated line,
+ * and a reply is one value per line, terminated by an empty line.
+ *
+ * The binary protocol (version 1) frames every message with a fixed
+ * 20 byte little endian header:
+ *
+ * - uint32 magic, "SCIF"
+ * - uint16 protocol version
+ * - uint16 message type (see MessageEnum)
+ * - uint32 request id, echoed by the reply
+ * - uint64 payload length
+ *
+ * Command, Reply and Error payloads are a sequence of typed fields, each a
+ * uint8 type tag followed by the value: a uint32 length and the bytes for
+ * strings, 8 bytes for Int64 and Double, 1 byte for Bool. Data payloads
+ * are raw pixel bytes. The first field of a command is its name, and an
+ * Error reply holds the Java message as a single string.
+ *
+ * \ingroup SCIFIO
+ */
+class SCIFIO_EXPORT SCIFIOBridgeProtocol
+{
+public:
+  static constexpr uint32_t Magic = 0x46494353;
+  static constexpr uint16_t Version = 1;
+  static constexpr size_t   HeaderLength = 20;
+
+  enum class MessageEnum : uint16_t
+  {
+    Command = 1,
+    Reply = 2,
+    Data = 3,
+    Error = 4
+  };
+
+  struct FrameHeader
+  {
+    MessageEnum Type;
+    uint32_t    RequestId;
+    uint64_t    PayloadLength;
+  };
+
+  /** Binary protocol */
+  static std::string
+  EncodeHeader(MessageEnum type, uint32_t requestId, uint64_t payloadLength);
+  static std::string
+  EncodeFrame(MessageEnum type, uint32_t requestId, const SCIFIOBridgeFields & fields);
+  static FrameHeader
+  DecodeHeader(const char * header);
+  static SCIFIOBridgeFields
+  DecodeFields(const char * payload, size_t length);
+
+  /** Text protocol */
+  static std::string
+  EncodeTextCommand(const SCIFIOBridgeFields & fields);
+  static SCIFIOBridgeFields
+  DecodeTextReply(const std::string & reply);
+};
+} // end namespace itk
+
+#endif // itkSCIFIOBridgeProtocol_h
@@ -0,0 +1,121 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSCIFIOBridgeStatistics_h
+#define itkSCIFIOBridgeStatistics_h
+
+#include "SCIFIOExport.h"
+#include "itkIntTypes.h"
+
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace itk
+{
+/** \class SCIFIOBridgeStatistics
+ *
+ * \brief Timings and volumes of the exchanges with SCIFIOITKBridge
+ * processes.
+ *
+ * Every SCIFIOImageIO keeps these counters for its own exchanges, see
+ * SCIFIOImageIO::GetBridgeStatistics(), and adds them to process-wide
+ * totals, see GetProcessTotals(). They are always collected: updating them
+ * costs little next to a round trip to the bridge.
+ *
+ * Command latencies are measured from sending a command to receiving the
+ * last byte of its reply, pixel data included, and are keyed by the name
+ * of the command ("canRead", "info", "series", "read", "readShm", "write",
+ * ...). Receive times are the times spent waiting for the bridge's output,
+ * so the receive throughput includes the decoding work of the bridge.
+ *
+ * Setting the SCIFIO_BRIDGE_STATISTICS environment variable to 1 prints
+ * the process-wide totals to std::cerr when the process exits.
+ *
+ * \ingroup SCIFIO
+ */
+struct SCIFIO_EXPORT SCIFIOBridgeStatistics
+{
+  /** Latency of one kind of command. */
+  struct CommandStatistics
+  {
+    SizeValueType Count{ 0 };
+    double        TotalSeconds{ 0.0 };
+    double        MaximumSeconds{ 0.0 };
+  };
+  using CommandMapType = std::map<std::string, CommandStatistics>;
+
+  /** Java processes started, and the time until they answered the
+   * capability negotiation. Without negotiation, the startup of the JVM
+   * shows in the latency of the first command instead. */
+  SizeValueType NumberOfSpawns{ 0 };
+  double        SpawnSeconds{ 0.0 };
+
+  CommandMapType Commands;
+
+  /** Bytes read from the stdout of the bridge, in how many pipe reads, and
+   * the time spent waiting for them. */
+  unsigned long long BytesReceived{ 0 };
+  SizeValueType      ChunksReceived{ 0 };
+  double             ReceiveSeconds{ 0.0 };
+
+  /** Part of the bytes received that were read straight into their
+   * destination, rather than copied there from a pipe buffer. */
+  unsigned long long BytesReceivedInPlace{ 0 };
+
+  /** Bytes written to the stdin of the bridge, in how many pipe writes,
+   * and the time spent writing them. */
+  unsigned long long BytesSent{ 0 };
+  SizeValueType      ChunksSent{ 0 };
+  double             SendSeconds{ 0.0 };
+
+  /** Pixel bytes exchanged through SCIFIOSharedMemory segments. */
+  unsigned long long SharedMemoryBytes{ 0 };
+
+  /** Output of the bridge on stderr. */
+  unsigned long long StderrBytes{ 0 };
+  SizeValueType      StderrChunks{ 0 };
+
+  /** Bytes per second received from, respectively sent to, the bridge
+   * through the pipes. Zero before any transfer. */
+  double
+  GetReceiveThroughput() const;
+  double
+  GetSendThroughput() const;
+
+  void
+  AddCommand(const std::string & name, double seconds);
+
+  /** Add the counters of other to these. */
+  void
+  Merge(const SCIFIOBridgeStatistics & other);
+
+  /** Print a human readable summary. */
+  void
+  Print(std::ostream & os) const;
+
+  /** Totals of all SCIFIOImageIO instances of the process. */
+  static SCIFIOBridgeStatistics
+  GetProcessTotals();
+  static void
+  AddToProcessTotals(const SCIFIOBridgeStatistics & statistics);
+  static void
+  ResetProcessTotals();
+};
+} // end namespace itk
+
+#endif // itkSCIFIOBridgeStatistics_h
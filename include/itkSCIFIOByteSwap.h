@@ -0,0 +1,83 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSCIFIOByteSwap_h
+#define itkSCIFIOByteSwap_h
+
+#include "SCIFIOExport.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace itk
+{
+/** \class SCIFIOByteSwap
+ *
+ * \brief Vectorized byte order conversion of pixel buffers.
+ *
+ * Reverses the bytes of each 16, 32 or 64-bit component of a buffer, with
+ * AVX2 or SSE2 instructions when the processor has them, and one component
+ * at a time otherwise. SCIFIOImageIO uses it to convert pixels shipped by
+ * the bridge in the byte order of the file while copying them into the
+ * output buffer.
+ *
+ * The instruction set is chosen once per process, from what the processor
+ * supports; SetInstructionSet() picks another one, e.g. for testing.
+ *
+ * \ingroup SCIFIO
+ */
+class SCIFIO_EXPORT SCIFIOByteSwap
+{
+public:
+  enum class InstructionSetEnum : uint8_t
+  {
+    SCALAR,
+    SSE2,
+    AVX2
+  };
+
+  /** Swap the bytes of count components of componentSize bytes from source
+   * into destination. The buffers must either be the same or not overlap,
+   * and need not be aligned. Components of a single byte, or of a size
+   * other than 2, 4 or 8, are copied as they are. */
+  static void
+  CopySwapRange(void * destination, const void * source, size_t componentSize, size_t count);
+
+  /** Swap the bytes of count components of componentSize bytes in place. */
+  static void
+  SwapRange(void * buffer, size_t componentSize, size_t count);
+
+  /** Whether this host stores the least significant byte first. */
+  static bool
+  IsSystemLittleEndian();
+
+  /** Instruction set used by the functions above. */
+  static InstructionSetEnum
+  GetInstructionSet();
+
+  /** Use the given instruction set from now on. Returns false, and changes
+   * nothing, if the processor does not support it. */
+  static bool
+  SetInstructionSet(InstructionSetEnum instructionSet);
+
+  /** Whether the processor supports the given instruction set. */
+  static bool
+  IsInstructionSetSupported(InstructionSetEnum instructionSet);
+};
+} // end namespace itk
+
+#endif // itkSCIFIOByteSwap_h
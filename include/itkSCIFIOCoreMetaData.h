@@ -0,0 +1,80 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSCIFIOCoreMetaData_h
+#define itkSCIFIOCoreMetaData_h
+
+#include "SCIFIOExport.h"
+#include "itkIntTypes.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+/** \class SCIFIOCoreMetaData
+ *
+ * \brief Typed core metadata of one series of a file: what is needed to
+ * plan reading it, and to read it.
+ *
+ * The fields are filled from the key/value pairs the bridge sends, named
+ * as in the reply to "info". SCIFIOImageIO parses them once per
+ * ReadImageInformation, rather than going through the string values of
+ * the metadata dictionary on every read. Spacings are as reported; a
+ * non-positive value means the file does not say.
+ *
+ * \ingroup SCIFIO
+ */
+struct SCIFIO_EXPORT SCIFIOCoreMetaData
+{
+  using EntryType = std::vector<std::pair<std::string, std::string>>;
+
+  std::string   Name;
+  SizeValueType SizeX{ 1 };
+  SizeValueType SizeY{ 1 };
+  SizeValueType SizeZ{ 1 };
+  SizeValueType SizeT{ 1 };
+  SizeValueType SizeC{ 1 };
+  double        PhysicalSizeX{ 0.0 };
+  double        PhysicalSizeY{ 0.0 };
+  double        PhysicalSizeZ{ 0.0 };
+  double        PhysicalSizeT{ 0.0 };
+  double        PhysicalSizeC{ 0.0 };
+  /** SCIFIO pixel type: 0 int8, 1 uint8, 2 int16, 3 uint16, 4 int32,
+   * 5 uint32, 6 float, 7 double. */
+  int           PixelType{ 1 };
+  unsigned int  RGBChannelCount{ 1 };
+  bool          Interleaved{ false };
+  bool          LittleEndian{ false };
+  int           ResolutionCount{ 1 };
+  SizeValueType OptimalTileWidth{ 0 };
+  SizeValueType OptimalTileHeight{ 0 };
+
+  /** Fill the fields found in entries; the others are left alone. Throws
+   * an itk::ExceptionObject if a value cannot be parsed. */
+  void
+  Parse(const EntryType & entries);
+
+  /** Whether key names one of the fields above, that the bridge always
+   * sends whatever the metadata level. */
+  static bool
+  IsCoreKey(const std::string & key);
+};
+} // end namespace itk
+
+#endif // itkSCIFIOCoreMetaData_h
@@ -0,0 +1,97 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSCIFIOFormatRegistry_h
+#define itkSCIFIOFormatRegistry_h
+
+#include "SCIFIOExport.h"
+#include "itkSCIFIOBridgeProtocol.h"
+
+#include <string>
+
+namespace itk
+{
+/** \class SCIFIOFormatRegistry
+ *
+ * \brief Process-wide list of the file formats the bridge supports, used
+ * to answer CanReadFile and CanWriteFile without a Java process.
+ *
+ * SCIFIOImageIOFactory offers SCIFIOImageIO for every file ITK opens, so
+ * most probes are for files that another ImageIO handles. The registry
+ * holds the suffixes SCIFIO reads and writes, and the signatures (bytes at
+ * a fixed offset) of the formats it recognizes by content. A file matching
+ * none of them is rejected right away; the others are still checked by the
+ * bridge.
+ *
+ * The bridge lists its formats in reply to a "formats" command, as pairs
+ * of fields: "read" or "write" followed by a lowercase suffix without the
+ * dot, or "magic" followed by an offset and the signature in hexadecimal,
+ * separated by a space. The list is saved next to the JAR files, and is
+ * reloaded from there as long as the JAR files are not modified, so the
+ * Java process is only needed once per installation.
+ *
+ * Only bridges with the "formats" capability can list their formats; the
+ * scifio-itk-bridge 1.2.1 that the build downloads by default cannot. With
+ * such bridges the registry stays empty, every file might be supported,
+ * and the first probe of each file still needs the Java process.
+ *
+ * The answers of the bridge are remembered per file, keyed by its
+ * canonical path, size and modification time, so probing the same file
+ * again is free, whatever the bridge.
+ *
+ * \ingroup SCIFIO
+ */
+class SCIFIO_EXPORT SCIFIOFormatRegistry
+{
+public:
+  /** Load the formats saved next to the JAR files of the given directory.
+   * Returns false if there are none, or if the JAR files changed since. */
+  static bool
+  Load(const std::string & jarDirectory);
+
+  /** Remember the formats listed in the reply to "formats", and save them
+   * next to the JAR files, if that directory is writable. */
+  static void
+  Register(const std::string & jarDirectory, const SCIFIOBridgeFields & formats);
+
+  /** Whether the formats were loaded or registered. Until then, every file
+   * might be supported. */
+  static bool
+  IsLoaded();
+
+  /** False if SCIFIO cannot read, respectively write, the file: its
+   * suffix is not supported, and for reading, its content does not match
+   * any signature either. */
+  static bool
+  MightRead(const std::string & fileName);
+  static bool
+  MightWrite(const std::string & fileName);
+
+  /** Answer of an earlier CanReadFile for the same, unmodified, file. */
+  static bool
+  FindCanRead(const std::string & fileName, bool & canRead);
+  static void
+  StoreCanRead(const std::string & fileName, bool canRead);
+
+  /** Forget the formats and the answers. The saved formats are left
+   * alone. */
+  static void
+  Clear();
+};
+} // end namespace itk
+
+#endif // itkSCIFIOFormatRegistry_h
@@ -20,14 +20,52 @@
 
 #include "SCIFIOExport.h"
 #include "itkStreamingImageIOBase.h"
+#include "itkSCIFIOBridgePool.h"
+#include "itkSCIFIOBridgeProtocol.h"
+#include "itkSCIFIOBridgeStatistics.h"
+#include "itkSCIFIOByteSwap.h"
+#include "itkSCIFIOCoreMetaData.h"
+#include "itkSCIFIOFormatRegistry.h"
+#include "itkSCIFIOImageRegionSplitter.h"
+#include "itkSCIFIOMetaDataCache.h"
+#include "itkSCIFIOPixelConversion.h"
+#include "itkSCIFIOSharedMemory.h"
+#include "itkSCIFIOTileCache.h"
 
 #include "itksys/Process.h"
 #include "itksys/SystemTools.hxx"
 
+#include <future>
+#include <memory>
+#include <mutex>
 #include <sstream>
 
 namespace itk
 {
+/** \class SCIFIOBridgeExitException
+ *
+ * \brief Thrown when a bridge process exits, or stops reading its input,
+ * in the middle of a command.
+ *
+ * SCIFIOImageIO runs the failed read, write or ReadImageInformation again
+ * on a new process up to GetMaximumNumberOfRestarts() times before letting
+ * this through.
+ *
+ * \ingroup SCIFIO
+ */
+class SCIFIO_EXPORT SCIFIOBridgeExitException : public ExceptionObject
+{
+public:
+  SCIFIOBridgeExitException(const std::string & file,
+                            unsigned int        line,
+                            const std::string & description,
+                            const std::string & location)
+    : ExceptionObject(file, line, description, location)
+  {}
+
+  itkOverrideGetNameOfClassMacro(SCIFIOBridgeExitException);
+};
+
 /** \class SCIFIOImageIO
  *
  * \brief Interface to the OME SCIFIO Java Library.
@@ -36,7 +74,15 @@ namespace itk
  * supported by the [SCIFIO] Java library, including [Bio-Formats].
  *
  * It invokes a Java process via a system call, and uses pipes to
- * communicate with it.
+ * communicate with it. Java processes are leased from the process-wide
+ * SCIFIOBridgePool, so the JVM startup cost is only paid once rather than
+ * once per SCIFIOImageIO instance. When the bridge supports it, pixel data
+ * is handed over through a SCIFIOSharedMemory segment instead of the pipes,
+ * and CanReadFile and CanWriteFile reject files of unsupported formats
+ * without a Java process, using the SCIFIOFormatRegistry. A segment holds
+ * a plane of the region read, and is kept between stream divisions only,
+ * or a plane of the image written, so /dev/shm must have room for it:
+ * otherwise the pipes are used, as with bridges that lack shared memory.
  *
  * The SCIFIO ImageIO module has the following runtime requirements:
  *
@@ -69,7 +115,39 @@ namespace itk
  * - JAVA_FLAGS - Used to pass any additional desired parameters to the Java
  *   execution. This is especially useful to override Java's maximum heap
  *   size, but also nice for tweaking the VM in many other ways (e.g.,
- *   garbage collection settings).
+ *   garbage collection settings). Setting -Xmx there disables the heap
+ *   sizing described in SetMemoryBudget().
+ * - SCIFIO_POOL_SIZE - Maximum number of idle Java processes kept alive
+ *   for reuse by later SCIFIOImageIO instances (default 4). See
+ *   SCIFIOBridgePool.
+ * - SCIFIO_POOL_IDLE_TIMEOUT - Number of seconds an idle Java process is
+ *   kept alive (default 300).
+ * - SCIFIO_NEGOTIATION_TIMEOUT - Number of seconds a new Java process is
+ *   given to list its protocol extensions before it is replaced by one
+ *   spoken to with the original text protocol (default 10).
+ * - SCIFIO_METADATA_CACHE - Set to 1 to enable the SCIFIOMetaDataCache by
+ *   default.
+ * - SCIFIO_METADATA_CACHE_DIR - Directory of the on-disk tier of the
+ *   SCIFIOMetaDataCache, shared between processes. Setting it also enables
+ *   the cache by default.
+ * - SCIFIO_METADATA_CACHE_SIZE - Maximum size of that directory, in
+ *   megabytes (default 64).
+ * - SCIFIO_BRIDGE_STATISTICS - Set to 1 to print the process-wide
+ *   SCIFIOBridgeStatistics when the process exits.
+ * - SCIFIO_CLASS_DATA_ARCHIVE - Set to 0 to start Java processes without
+ *   the class data sharing archive made at build or install time.
+ *
+ * Errors reported by the bridge, such as an unreadable or corrupt file, are
+ * thrown as ExceptionObjects carrying the Java message. The Java process is
+ * replaced by a new one on the next command. Processes that die in the
+ * middle of a command are replaced right away, and the command retried; see
+ * SetMaximumNumberOfRestarts().
+ *
+ * Sizes and offsets are 64-bit throughout, for images, and planes, beyond
+ * 2^31 pixels or bytes. Images of 64-bit integers are read and written as
+ * such with bridges that support them, see the "int64" capability of
+ * SCIFIOBridgeWorker; other bridges report them as doubles, and refuse to
+ * write them.
  *
  * [scifio]:       https://openmicroscopy.org/site/support/bio-formats/developers/scifio.html
  * [bio-formats]:  https://openmicroscopy.org/site/products/bio-formats
@@ -85,6 +163,18 @@ public:
   using Pointer = SmartPointer<Self>;
   using ConstPointer = SmartPointer<const Self>;
 
+  /** How much of the metadata of a file ReadImageInformation puts into the
+   * metadata dictionary. */
+  enum class MetaDataLevelEnum : uint8_t
+  {
+    /** Only the fields of SCIFIOCoreMetaData. */
+    CORE,
+    /** The core fields, and the keys selected by the metadata filter. */
+    FILTERED,
+    /** Everything the format reports, including the original metadata. */
+    FULL
+  };
+
   /** Method for creation through the object factory **/
   itkNewMacro(Self);
 
@@ -99,14 +189,47 @@ public:
   bool
   CanReadFile(const char * FileNameToRead) override;
 
-  /* Sets the series to read in a multi-series dataset */
+  /* Sets the file name; a pending prefetch of another file is dropped */
+  using Superclass::SetFileName;
+  void
+  SetFileName(const char * fileName) override;
+
+  /* Sets the series to read in a multi-series dataset. The bridge is only
+   * told when it next needs to know, so switching series is free; like
+   * the resolution level, it must be followed by ReadImageInformation. */
   virtual bool
   SetSeries(int series);
+  int
+  GetSeries() const;
 
   /* Sets the series to read in a multi-series dataset */
   virtual int
   GetSeriesCount();
 
+  /** Core metadata (sizes, pixel type, spacing, resolution count) of every
+   * series of the file, to plan work across all series before reading any
+   * pixels. Bridges with the "seriesTable" capability send it in reply to
+   * a single command; with older bridges every series is queried in turn.
+   * Kept until the file name changes. */
+  const std::vector<SCIFIOCoreMetaData> &
+  GetSeriesTable();
+
+  /** Number of resolution levels of the current series, for pyramidal
+   * formats such as SVS, NDPI or OME-TIFF pyramids. Level 0 is the full
+   * resolution. Bridges without the "resolutions" capability always
+   * report a single level. */
+  virtual int
+  GetResolutionCount();
+
+  /** Select the resolution level of the current series that
+   * ReadImageInformation describes and Read fetches. Like SetSeries, this
+   * must be followed by ReadImageInformation; selecting a series goes back
+   * to level 0. Returns false if the level does not exist. */
+  virtual bool
+  SetResolutionLevel(int level);
+  int
+  GetResolutionLevel() const;
+
   /* Set the spacing and dimension information for the set file name */
   void
   ReadImageInformation() override;
@@ -115,6 +238,73 @@ public:
   void
   Read(void * buffer) override;
 
+  /** The core fields of the image information, as parsed by the last
+   * ReadImageInformation. */
+  const SCIFIOCoreMetaData &
+  GetCoreMetaData() const
+  {
+    return m_CoreMetaData;
+  }
+
+  /** Width and height of the tiles the format stores planes in, as
+   * reported by the bridge after ReadImageInformation. Strips are tiles
+   * as wide as the plane. Zero when the bridge does not report them. */
+  SizeValueType
+  GetOptimalTileWidth() const
+  {
+    return m_CoreMetaData.OptimalTileWidth;
+  }
+  SizeValueType
+  GetOptimalTileHeight() const
+  {
+    return m_CoreMetaData.OptimalTileHeight;
+  }
+
+  /** A SCIFIOImageRegionSplitter on the tiles of the file, set up by
+   * ReadImageInformation. Stream divisions are cut by the filter that
+   * streams the reader, such as a StreamingImageFilter: give it this
+   * splitter, with
+   * streamer->SetRegionSplitter(io->GetModifiableRegionSplitter()),
+   * so that no tile is decoded by two divisions. */
+  itkGetModifiableObjectMacro(RegionSplitter, SCIFIOImageRegionSplitter);
+
+  /** Exchange pixel data with the bridge through shared memory when the
+   * bridge supports it, rather than through its stdout/stdin pipes.
+   * Enabled by default; the pipes are used whenever shared memory is not
+   * available. */
+  itkSetMacro(UseSharedMemory, bool);
+  itkGetConstMacro(UseSharedMemory, bool);
+  itkBooleanMacro(UseSharedMemory);
+
+  /** Have the bridge ship the pixels in the byte order of the file, and
+   * convert them here with the vectorized SCIFIOByteSwap while copying them
+   * into the output buffer, rather than in Java one value at a time.
+   * Enabled by default; only bridges with the "rawBytes" capability can do
+   * it. The byte order reported by GetByteOrder() is that of the file
+   * either way. */
+  itkSetMacro(UseRawByteOrder, bool);
+  itkGetConstMacro(UseRawByteOrder, bool);
+  itkBooleanMacro(UseRawByteOrder);
+
+  /** Have the bridge ship the channels of files that store them in
+   * separate planes as they are stored, one plane after the other, and
+   * interleave them here with SCIFIOPixelConversion::ConvertPlanar()
+   * straight into the output buffer, rather than in Java. Enabled by
+   * default; only bridges with the "nativeLayout" capability can do it. */
+  itkSetMacro(UseNativeLayout, bool);
+  itkGetConstMacro(UseNativeLayout, bool);
+  itkBooleanMacro(UseNativeLayout);
+
+  /** Component type to deliver the pixels in, rather than that of the
+   * file. ReadImageInformation reports it as the component type, so that
+   * an ImageFileReader of images of that type reads straight into its
+   * output buffer: the pixels are converted as they come from the bridge,
+   * instead of by the reader, in a second buffer the size of the image.
+   * UNKNOWNCOMPONENTTYPE, the default, keeps the type of the file. */
+  void
+  SetTargetComponentType(IOComponentEnum componentType);
+  itkGetConstMacro(TargetComponentType, IOComponentEnum);
+
   /**---------------Write the data------------------**/
 
   bool
@@ -128,6 +318,165 @@ public:
   void
   Write(const void * buffer) override;
 
+  /** Stream each plane to the bridge in a single length-prefixed chunk,
+   * with one acknowledgement per image, when the bridge supports it.
+   * When disabled, or with older bridges, planes are sent in 10000 byte
+   * slices that are each acknowledged by the bridge. Enabled by default. */
+  itkSetMacro(UseStreamedWrite, bool);
+  itkGetConstMacro(UseStreamedWrite, bool);
+  itkBooleanMacro(UseStreamedWrite);
+
+  /** Look up the image information in the SCIFIOMetaDataCache before
+   * asking the bridge, so that reopening an unchanged file does not need
+   * the Java process at all. Disabled by default, unless the
+   * SCIFIO_METADATA_CACHE or SCIFIO_METADATA_CACHE_DIR environment
+   * variable is set. */
+  itkSetMacro(UseMetaDataCache, bool);
+  itkGetConstMacro(UseMetaDataCache, bool);
+  itkBooleanMacro(UseMetaDataCache);
+
+  /** Amount of metadata ReadImageInformation reads. Formats such as CZI,
+   * LIF or ND2 carry tens of thousands of original metadata entries, which
+   * most pipelines never look at; with CORE or FILTERED they stay on the
+   * Java side. Bridges with the "metadataLevel" capability only send what
+   * is selected; with older bridges the rest is dropped before it is
+   * unescaped. Defaults to FULL. Must be followed by ReadImageInformation. */
+  void
+  SetMetaDataLevel(MetaDataLevelEnum level);
+  MetaDataLevelEnum
+  GetMetaDataLevel() const;
+
+  /** Keys kept at the FILTERED metadata level, besides the core fields. An
+   * entry ending with '*' selects all keys starting with the rest of it. */
+  void
+  SetMetaDataFilter(const std::vector<std::string> & filter);
+  const std::vector<std::string> &
+  GetMetaDataFilter() const;
+
+  /** The metadata dictionary with all the metadata of the current image.
+   * When the metadata level left some of it out, it is fetched on the first
+   * call and merged into the metadata dictionary. */
+  const MetaDataDictionary &
+  GetFullMetaDataDictionary();
+
+  /** Number of Java processes reading a region in parallel. The region is
+   * split into contiguous slabs along its slowest varying axis (Z, T or C,
+   * or rows for a single plane), each read by its own worker leased from
+   * the SCIFIOBridgePool. Zero means
+   * MultiThreaderBase::GetGlobalDefaultNumberOfThreads(). Each worker is a
+   * JVM whose heap may grow up to the memory budget, so this defaults to 1
+   * whatever the number of threads of ITK. */
+  itkSetMacro(NumberOfReadWorkers, unsigned int);
+  itkGetConstMacro(NumberOfReadWorkers, unsigned int);
+
+  /** After each Read, read the region that follows it along the slowest
+   * axis not read whole, in the background, with an additional Java
+   * process. When the next Read asks for that region, as successive stream
+   * divisions do, it is served from memory. Once a Read asks for another
+   * region, nothing more is prefetched until the next
+   * ReadImageInformation, since each wrong guess costs a whole read.
+   * Disabled by default. */
+  itkSetMacro(UsePrefetch, bool);
+  itkGetConstMacro(UsePrefetch, bool);
+  itkBooleanMacro(UsePrefetch);
+
+  /** Number of Reads served from, respectively not matching, the prefetched
+   * region since this instance was created. */
+  itkGetConstMacro(PrefetchHits, SizeValueType);
+  itkGetConstMacro(PrefetchMisses, SizeValueType);
+
+  /** Keep up to the given number of bytes of recently read tiles in a
+   * SCIFIOTileCache, and assemble requested regions from them, only asking
+   * the bridge for the missing tiles. Useful when overlapping or repeated
+   * regions of the same file are read. Zero, the default, disables it. */
+  void
+  SetTileCacheSize(size_t size)
+  {
+    if (size != m_TileCache.GetMaximumSize())
+    {
+      m_TileCache.SetMaximumSize(size);
+      this->Modified();
+    }
+  }
+  size_t
+  GetTileCacheSize() const
+  {
+    return m_TileCache.GetMaximumSize();
+  }
+
+  /** Width and height of the cached tiles. Zero, the default, caches the
+   * tiles of the file, as reported by GetOptimalTileWidth() and
+   * GetOptimalTileHeight(), or tiles of 512 pixels when it reports none.
+   * A missing tile is read across all the planes of the requested region
+   * at once. */
+  itkSetMacro(TileCacheTileSize, unsigned int);
+  itkGetConstMacro(TileCacheTileSize, unsigned int);
+
+  /** Number of tiles found in, respectively missing from, the tile cache
+   * since this instance was created. */
+  SizeValueType
+  GetTileCacheHits() const
+  {
+    return m_TileCache.GetNumberOfHits();
+  }
+  SizeValueType
+  GetTileCacheMisses() const
+  {
+    return m_TileCache.GetNumberOfMisses();
+  }
+
+  /** Whether the Java processes are started with the class data sharing
+   * archive of the bridge classes, made next to the JAR files at build or
+   * install time. It is only used when it was made for the same Java
+   * runtime and JAR files. */
+  itkGetConstMacro(UseClassDataArchive, bool);
+
+  /** Upper bound, in megabytes, of the heap of each Java process of this
+   * instance. The heap starts at 256 MB, and grows with the size of the
+   * planes read or written. When the bridge runs out of memory anyway, the
+   * heap is doubled, up to this budget, and the failed read, write or
+   * ReadImageInformation runs again with a new Java process. Zero, the
+   * default, means a quarter of the physical memory. Has no effect when
+   * JAVA_FLAGS sets -Xmx. */
+  itkSetMacro(MemoryBudget, SizeValueType);
+  itkGetConstMacro(MemoryBudget, SizeValueType);
+
+  /** Heap size, in megabytes, of the Java processes this instance uses
+   * from now on. Idle processes of the pool with a larger heap, within the
+   * memory budget, are reused rather than new ones started, in which case
+   * this is their heap size. */
+  itkGetConstMacro(JavaHeapSize, SizeValueType);
+
+  /** Number of times a read, write or ReadImageInformation is run again
+   * with a new Java process when the previous one exited in the middle of
+   * it (default 2). Errors reported by the bridge itself are not retried:
+   * they are thrown right away. Before a write is run again, the file left
+   * by the failed attempt is removed, unless it existed before the write. */
+  itkSetMacro(MaximumNumberOfRestarts, unsigned int);
+  itkGetConstMacro(MaximumNumberOfRestarts, unsigned int);
+
+  /** Largest number of bytes read with a single command. The bridge holds
+   * the pixels it ships in a Java array, which cannot exceed 2^31 - 1
+   * elements, so larger regions are read in pieces along their slowest
+   * axis, down to single rows. 1 GiB by default. */
+  itkSetMacro(MaximumTransferSize, SizeValueType);
+  itkGetConstMacro(MaximumTransferSize, SizeValueType);
+
+  /** Spawn time, command latencies and transfer volumes of the exchanges
+   * of this instance with the bridge, since it was created or since the
+   * last ResetBridgeStatistics(). SCIFIOBridgeStatistics::GetProcessTotals()
+   * sums them over all instances. */
+  SCIFIOBridgeStatistics
+  GetBridgeStatistics() const;
+  void
+  ResetBridgeStatistics();
+
+  /** Whether the bridge understands the given protocol extension, as
+   * listed in SCIFIOBridgeWorker. Starts the Java process of this instance
+   * if it is not running yet. */
+  bool
+  HasBridgeCapability(const std::string & capability);
+
 protected:
   SCIFIOImageIO();
   ~SCIFIOImageIO() override;
@@ -143,32 +492,161 @@ private:
   CreateJavaProcess();
   void
   DestroyJavaProcess();
-  std::string
+  void
+  LoadFormatRegistry();
+  SCIFIOBridgeFields
   FindDimensionOrder(const ImageIORegion & region);
+  void
+  WaitForBridgeData(SCIFIOBridgeWorker * worker,
+                    char **              data,
+                    int *                length,
+                    std::string &        errorMessage,
+                    char *               destination = nullptr,
+                    size_t               capacity = 0);
+  void
+  HandleOutOfMemory(SCIFIOBridgeWorker * worker, const std::string & message);
   std::string
-  WaitForNewLines(int pipedatalength);
+  WaitForNewLines(SCIFIOBridgeWorker * worker);
   void
-  CheckError(std::string message);
-  bool
-  CheckJavaPath(std::string javaHome, std::string & javaCmd);
+  ReadFromBridge(SCIFIOBridgeWorker * worker, void * buffer, size_t length);
+  void
+  SendCommand(SCIFIOBridgeWorker * worker, const SCIFIOBridgeFields & command);
+  SCIFIOBridgeProtocol::FrameHeader
+  ReceiveFrameHeader(SCIFIOBridgeWorker * worker);
+  SCIFIOBridgeFields
+  ReceiveReply(SCIFIOBridgeWorker * worker);
+  SCIFIOBridgeFields
+  ExecuteCommand(SCIFIOBridgeWorker * worker, const SCIFIOBridgeFields & command);
+  void
+  WriteToBridge(SCIFIOBridgeWorker * worker, const void * data, size_t length);
+  SCIFIOBridgeFields
+  MakeInfoCommand(MetaDataLevelEnum level) const;
   std::string
-  RemoveFinalSlash(std::string path) const;
+  GetMetaDataSelection(MetaDataLevelEnum level) const;
+  bool
+  IsMetaDataSelected(const std::string & key, MetaDataLevelEnum level) const;
+  void
+  ParseImageInformation(const SCIFIOBridgeFields &       imgInfo,
+                        SCIFIOMetaDataCache::EntryType & entries,
+                        MetaDataLevelEnum                level);
+  void
+  SelectImage(SCIFIOBridgeWorker * worker, int series, int resolution);
+  void
+  SelectCurrentImage();
+  void
+  RecordStatistics(const SCIFIOBridgeStatistics & statistics);
+  void
+  RecordCommand(const std::string & name, double seconds);
+  void
+  RecordSpawn(SCIFIOBridgeWorker * worker);
+  SizeValueType
+  GetMemoryBudgetToUse() const;
+  void
+  SetJavaHeapSize(SizeValueType megabytes);
+  SizeValueType
+  GetLargestJavaHeapSize() const;
+  void
+  ReserveJavaHeap(size_t planeBytes);
+  bool
+  GrowJavaHeap();
 
-  char **
-  toCArray(std::vector<std::string> & args)
+  // Run function again with a larger heap while the bridge runs out of
+  // memory, within the memory budget, and with a new process when the
+  // bridge exits, up to the maximum number of restarts
+  template <typename TFunction>
+  void
+  RetryOnBridgeFailure(TFunction function)
   {
-    auto ** argv = new char *[args.size() + 1];
-    for (int i = 0; i < static_cast<int>(args.size()); i++)
+    unsigned int restarts = 0;
+    while (true)
     {
-      itkDebugMacro("SCIFIOImageIO::toCArray::args[" << i << "] = " << args[i]);
-      argv[i] = (char *)args[i].c_str();
+      try
+      {
+        function();
+        return;
+      }
+      catch (MemoryAllocationError &)
+      {
+        if (!GrowJavaHeap())
+        {
+          throw;
+        }
+        itkDebugMacro("Retrying with a heap of " << m_JavaHeapSize << " MB");
+      }
+      catch (SCIFIOBridgeExitException & e)
+      {
+        if (restarts++ >= m_MaximumNumberOfRestarts)
+        {
+          throw;
+        }
+        itkWarningMacro("Restarting the bridge: " << e.GetDescription());
+      }
     }
-    argv[args.size()] = nullptr;
-    return argv;
   }
+  unsigned int
+  GetNumberOfReadWorkersToUse() const;
+  SCIFIOBridgeWorker *
+  LeaseHelperWorker();
+  void
+  ReleaseHelperWorker(SCIFIOBridgeWorker * worker, bool failed);
+  void
+  StartPrefetch(const ImageIORegion & region, size_t byteCount);
+  bool
+  FinishPrefetch(const ImageIORegion & region, void * buffer, size_t byteCount);
+  void
+  StopPrefetch();
+  void
+  ReadRegionThroughTileCache(const ImageIORegion & region, void * buffer);
+  void
+  ReadRegionWithWorkers(const ImageIORegion & region, void * buffer, size_t byteCount);
+  void
+  ReadRegion(SCIFIOBridgeWorker *                  worker,
+             const std::string &                   fileName,
+             const SCIFIOBridgeFields &            dimensions,
+             void *                                buffer,
+             size_t                                byteCount,
+             std::unique_ptr<SCIFIOSharedMemory> & sharedMemory);
+  bool
+  ReadThroughSharedMemory(SCIFIOBridgeWorker *                  worker,
+                          const std::string &                   fileName,
+                          const SCIFIOBridgeFields &            dimensions,
+                          void *                                buffer,
+                          size_t                                byteCount,
+                          std::unique_ptr<SCIFIOSharedMemory> & sharedMemory,
+                          bool                                  rawByteOrder,
+                          size_t                                planePixels);
+  size_t
+  GetBridgeByteCount(size_t byteCount) const;
+  void
+  CopyPixelsFromBridge(void *       buffer,
+                       const void * source,
+                       size_t       count,
+                       bool         rawByteOrder,
+                       size_t       planePixels) const;
+  bool
+  WriteThroughSharedMemory(const SCIFIOBridgeFields & writeCommand,
+                           const void *               buffer,
+                           size_t                     byteCount,
+                           SizeValueType              numberOfPlanes);
+  void
+  WriteImage(const void * buffer);
+  void
+  CheckError(SCIFIOBridgeWorker * worker, const std::string & output);
+  void
+  DiscardWorker(SCIFIOBridgeWorker * worker);
+  bool
+  CheckJavaPath(std::string javaHome, std::string & javaCmd);
+  std::string
+  RemoveFinalSlash(std::string path) const;
 
+  // Pixel types as sent by the bridge: 0 to 7 are the INT8, UINT8, INT16,
+  // UINT16, INT32, UINT32, FLOAT and DOUBLE constants of Bio-Formats'
+  // FormatTools. 9 (signed) and 10 (unsigned 64-bit integers) are not
+  // FormatTools constants, which end with BIT = 8: they are defined by the
+  // "int64" extension of the bridge protocol, see SCIFIOBridgeWorker, and
+  // only sent by bridges that negotiated it.
   IOComponentEnum
-  scifioToITKComponentType(int pixelType)
+  scifioToITKComponentType(int pixelType) const
   {
     switch (pixelType)
     {
@@ -186,13 +664,19 @@ private:
         return IOComponentEnum::UINT;
       case 6:
         return IOComponentEnum::FLOAT;
+      case 9:
+        return IOComponentEnum::LONGLONG;
+      case 10:
+        return IOComponentEnum::ULONGLONG;
       default:
         return IOComponentEnum::DOUBLE;
     }
   }
 
+  // 9 and 10 are only understood by bridges with the "int64" capability,
+  // see scifioToITKComponentType
   int
-  itkToSCIFIOPixelType(ImageIOBase::IOComponentEnum cmp)
+  itkToSCIFIOPixelType(ImageIOBase::IOComponentEnum cmp) const
   {
     switch (cmp)
     {
@@ -211,18 +695,62 @@ private:
       case IOComponentEnum::FLOAT:
         return 6;
       case IOComponentEnum::LONG:
+        return sizeof(long) == 4 ? 4 : 9;
       case IOComponentEnum::ULONG:
+        return sizeof(long) == 4 ? 5 : 10;
+      case IOComponentEnum::LONGLONG:
+        return 9;
+      case IOComponentEnum::ULONGLONG:
+        return 10;
       case IOComponentEnum::DOUBLE:
       default:
         return 7;
     }
   }
 
-  MetaDataDictionary        m_MetaDataDictionary;
-  std::vector<std::string>  m_Args;
-  char **                   m_Argv;
-  itksysProcess_Pipe_Handle m_Pipe[2];
-  itksysProcess *           m_Process;
+  MetaDataDictionary                  m_MetaDataDictionary;
+  SCIFIOCoreMetaData                  m_CoreMetaData;
+  std::vector<std::string>            m_Args;
+  std::string                         m_JarDirectory;
+  SCIFIOBridgeWorker *                m_Worker;
+  int                                 m_Series;
+  int                                 m_Resolution;
+  std::vector<SCIFIOCoreMetaData>     m_SeriesTable;
+  std::string                         m_SeriesTableFileName;
+  bool                                m_UseSharedMemory;
+  bool                                m_UseRawByteOrder;
+  bool                                m_UseNativeLayout;
+  IOComponentEnum                     m_TargetComponentType;
+  bool                                m_UseStreamedWrite;
+  unsigned int                        m_NumberOfReadWorkers;
+  bool                                m_UsePrefetch;
+  SCIFIOBridgeWorker *                m_PrefetchWorker;
+  std::string                         m_PrefetchFileName;
+  int                                 m_PrefetchSeries;
+  int                                 m_PrefetchResolution;
+  ImageIORegion                       m_PrefetchRegion;
+  std::vector<char>                   m_PrefetchBuffer;
+  std::future<void>                   m_PrefetchResult;
+  bool                                m_PrefetchMissed;
+  SizeValueType                       m_PrefetchHits;
+  SizeValueType                       m_PrefetchMisses;
+  unsigned int                        m_TileCacheTileSize;
+  SCIFIOTileCache                     m_TileCache;
+  bool                                m_UseMetaDataCache;
+  MetaDataLevelEnum                   m_MetaDataLevel;
+  std::vector<std::string>            m_MetaDataFilter;
+  bool                                m_FullMetaDataRead;
+  bool                                m_UseClassDataArchive;
+  SizeValueType                       m_MemoryBudget;
+  SizeValueType                       m_JavaHeapSize;
+  bool                                m_JavaHeapIsAdjustable;
+  size_t                              m_JavaHeapArgument;
+  unsigned int                        m_MaximumNumberOfRestarts;
+  SizeValueType                       m_MaximumTransferSize;
+  std::unique_ptr<SCIFIOSharedMemory> m_SharedMemory;
+  SCIFIOImageRegionSplitter::Pointer  m_RegionSplitter;
+  SCIFIOBridgeStatistics              m_Statistics;
+  mutable std::mutex                  m_StatisticsMutex;
 };
 } // end namespace itk
 
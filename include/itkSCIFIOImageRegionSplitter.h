@@ -0,0 +1,115 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSCIFIOImageRegionSplitter_h
+#define itkSCIFIOImageRegionSplitter_h
+
+#include "SCIFIOExport.h"
+#include "itkImageIORegion.h"
+#include "itkImageRegionSplitterBase.h"
+#include "itkObjectFactory.h"
+
+namespace itk
+{
+/** \class SCIFIOImageRegionSplitter
+ *
+ * \brief Splits regions on the tile grid of the file being read.
+ *
+ * Formats such as TIFF or SVS store each plane as a grid of tiles (or as
+ * strips, which are tiles as wide as the plane), and the bridge decodes
+ * whole tiles even when only part of one is asked for. This splitter cuts
+ * along the slowest axis that spans more than one tile, like
+ * ImageRegionSplitterSlowDimension, but only on tile boundaries along X
+ * and Y, so that no tile is shared by two pieces.
+ *
+ * The grid starts at index 0. A tile width or height of zero, meaning the
+ * tiling is unknown, is handled like a tile size of one pixel.
+ *
+ * SCIFIOImageIO::GetModifiableRegionSplitter() returns one on the tiles of
+ * the file read, for the filters that stream the reader.
+ *
+ * \ingroup SCIFIO
+ */
+class SCIFIO_EXPORT SCIFIOImageRegionSplitter : public ImageRegionSplitterBase
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SCIFIOImageRegionSplitter);
+
+  /** Standard class type alias **/
+  using Self = SCIFIOImageRegionSplitter;
+  using Superclass = ImageRegionSplitterBase;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory **/
+  itkNewMacro(Self);
+
+  /** RTTI (and related methods) **/
+  itkOverrideGetNameOfClassMacro(SCIFIOImageRegionSplitter);
+
+  /** Size of the tiles along X and Y. */
+  itkSetMacro(TileWidth, SizeValueType);
+  itkGetConstMacro(TileWidth, SizeValueType);
+  itkSetMacro(TileHeight, SizeValueType);
+  itkGetConstMacro(TileHeight, SizeValueType);
+
+  using Superclass::GetNumberOfSplits;
+  using Superclass::GetSplit;
+
+  /** Same as the ImageRegion versions, for the regions ImageIOBase deals
+   * with. */
+  unsigned int
+  GetNumberOfSplits(const ImageIORegion & region, unsigned int requestedNumber) const;
+  unsigned int
+  GetSplit(unsigned int i, unsigned int numberOfPieces, ImageIORegion & region) const;
+
+protected:
+  SCIFIOImageRegionSplitter() = default;
+  ~SCIFIOImageRegionSplitter() override = default;
+
+  unsigned int
+  GetNumberOfSplitsInternal(unsigned int         dim,
+                            const IndexValueType regionIndex[],
+                            const SizeValueType  regionSize[],
+                            unsigned int         requestedNumber) const override;
+
+  unsigned int
+  GetSplitInternal(unsigned int   dim,
+                   unsigned int   i,
+                   unsigned int   numberOfPieces,
+                   IndexValueType regionIndex[],
+                   SizeValueType  regionSize[]) const override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  SizeValueType
+  GetTileSize(unsigned int axis) const;
+  bool
+  FindSplitAxis(unsigned int         dim,
+                const IndexValueType regionIndex[],
+                const SizeValueType  regionSize[],
+                unsigned int &       axis,
+                SizeValueType &      numberOfTiles) const;
+
+  SizeValueType m_TileWidth{ 0 };
+  SizeValueType m_TileHeight{ 0 };
+};
+} // end namespace itk
+
+#endif // itkSCIFIOImageRegionSplitter_h
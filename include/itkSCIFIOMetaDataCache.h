@@ -0,0 +1,115 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSCIFIOMetaDataCache_h
+#define itkSCIFIOMetaDataCache_h
+
+#include "SCIFIOExport.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+/** \class SCIFIOMetaDataCache
+ *
+ * \brief Process-wide cache of the image information read by SCIFIOImageIO.
+ *
+ * Asking the bridge for the metadata of a file means parsing the file in
+ * Java, which can take a while for some formats. The key/value pairs it
+ * returns, from which all core fields (sizes, spacing, pixel type, byte
+ * order, RGBChannelCount, ...) are derived, are therefore remembered here,
+ * keyed by the canonical path, stamp (see GetFileStamp()), series and
+ * resolution level of the file. Touching or replacing the file
+ * invalidates its entries. Entries holding only part of the metadata, as
+ * selected by the metadata level of SCIFIOImageIO, are told apart by a
+ * selection string.
+ *
+ * There are two tiers:
+ *
+ * - an in-memory tier, holding up to GetMaximumNumberOfEntries() entries,
+ *   evicting the least recently used ones;
+ * - an optional on-disk tier, shared between processes, enabled by setting
+ *   a directory with SetDirectory() or the SCIFIO_METADATA_CACHE_DIR
+ *   environment variable. Entries are stored one per file, and the least
+ *   recently used files are removed once the directory grows beyond
+ *   GetMaximumDiskSize() bytes (SCIFIO_METADATA_CACHE_SIZE, in megabytes,
+ *   64 by default).
+ *
+ * \ingroup SCIFIO
+ */
+class SCIFIO_EXPORT SCIFIOMetaDataCache
+{
+public:
+  /** Metadata of one image, in the order sent by the bridge. */
+  using EntryType = std::vector<std::pair<std::string, std::string>>;
+
+  /** Look up the metadata of the given series and resolution level of a
+   * file. Returns false if it is not cached, or if the file changed since
+   * it was cached. The selection names the part of the metadata wanted;
+   * empty means all of it. */
+  static bool
+  Find(const std::string & fileName,
+       int                 series,
+       int                 resolution,
+       EntryType &         entry,
+       const std::string & selection = std::string());
+
+  /** Remember the metadata of the given series and resolution level of a
+   * file, restricted to the given selection. */
+  static void
+  Store(const std::string & fileName,
+        int                 series,
+        int                 resolution,
+        const EntryType &   entry,
+        const std::string & selection = std::string());
+
+  /** Directory of the on-disk tier. Empty disables it. */
+  static void
+  SetDirectory(const std::string & directory);
+  static std::string
+  GetDirectory();
+
+  /** Maximum number of entries of the in-memory tier. */
+  static void
+  SetMaximumNumberOfEntries(unsigned int number);
+  static unsigned int
+  GetMaximumNumberOfEntries();
+
+  /** Maximum total size of the on-disk tier, in bytes. */
+  static void
+  SetMaximumDiskSize(unsigned long long size);
+  static unsigned long long
+  GetMaximumDiskSize();
+
+  /** Size, modification time and inode of a file, or an empty string if
+   * it is not a regular file. The modification time has the resolution of
+   * the file system timestamps, a few milliseconds or better on most, but
+   * whole seconds on Windows, where the inode is not available either:
+   * rewriting a file in place with the same size within that resolution
+   * goes unnoticed. */
+  static std::string
+  GetFileStamp(const std::string & fileName);
+
+  /** Forget the in-memory entries. The on-disk tier is left alone. */
+  static void
+  Clear();
+};
+} // end namespace itk
+
+#endif // itkSCIFIOMetaDataCache_h
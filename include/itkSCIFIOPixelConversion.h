@@ -0,0 +1,83 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSCIFIOPixelConversion_h
+#define itkSCIFIOPixelConversion_h
+
+#include "SCIFIOExport.h"
+#include "itkImageIOBase.h"
+
+namespace itk
+{
+/** \class SCIFIOPixelConversion
+ *
+ * \brief Conversion of pixel components between the component types the
+ * bridge reports, and the 64-bit integer types.
+ *
+ * SCIFIOImageIO uses it to deliver pixels in the component type of the
+ * output image while they come from the bridge, instead of leaving the
+ * conversion to ImageFileReader, which needs a second image-sized buffer
+ * for it. Values are converted as with static_cast, like
+ * ConvertPixelBuffer does. The common conversions of 8 and 16-bit
+ * integers to float, and of float to double, use SSE2 instructions unless
+ * SCIFIOByteSwap is restricted to scalar code. Planar pixels of 2, 3 or 4
+ * channels are interleaved with SSSE3 byte shuffles when SCIFIOByteSwap
+ * uses AVX2, and in cache-sized blocks otherwise.
+ *
+ * \ingroup SCIFIO
+ */
+class SCIFIO_EXPORT SCIFIOPixelConversion
+{
+public:
+  using IOComponentEnum = ImageIOBase::IOComponentEnum;
+
+  /** Whether Convert() handles the given component types. */
+  static bool
+  IsSupported(IOComponentEnum sourceType, IOComponentEnum destinationType);
+
+  /** Size in bytes of a component of the given type, or 0 if it is not
+   * supported. */
+  static size_t
+  GetComponentTypeSize(IOComponentEnum componentType);
+
+  /** Convert count components of sourceType into destinationType. The
+   * bytes of the source components are swapped first if swapSource is set;
+   * the source itself is left alone. Both buffers must be aligned for their
+   * types, and must not overlap. */
+  static void
+  Convert(void *          destination,
+          IOComponentEnum destinationType,
+          const void *    source,
+          IOComponentEnum sourceType,
+          size_t          count,
+          bool            swapSource);
+
+  /** Same as Convert(), for numberOfPixels pixels of numberOfChannels
+   * channels stored one channel after the other in source, which are
+   * interleaved into destination as ITK lays out multi-component pixels. */
+  static void
+  ConvertPlanar(void *          destination,
+                IOComponentEnum destinationType,
+                const void *    source,
+                IOComponentEnum sourceType,
+                unsigned int    numberOfChannels,
+                size_t          numberOfPixels,
+                bool            swapSource);
+};
+} // end namespace itk
+
+#endif // itkSCIFIOPixelConversion_h
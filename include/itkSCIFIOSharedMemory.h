@@ -0,0 +1,88 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSCIFIOSharedMemory_h
+#define itkSCIFIOSharedMemory_h
+
+#include "SCIFIOExport.h"
+
+#include <cstddef>
+#include <string>
+
+namespace itk
+{
+/** \class SCIFIOSharedMemory
+ *
+ * \brief A memory segment shared with the SCIFIOITKBridge Java process.
+ *
+ * The segment is a file in the POSIX shared memory file system
+ * (/dev/shm), mapped into our address space. Java maps the same file by
+ * path, so pixel data can be exchanged without going through a pipe.
+ *
+ * The space of the segment is reserved in the file system when it is
+ * created, so that a file system too small for it, such as the 64 MB
+ * /dev/shm of a default Docker container, makes the constructor throw
+ * rather than the first access to the memory raise SIGBUS. Callers fall
+ * back to the pipes in that case.
+ *
+ * The file is unlinked when the segment is destroyed.
+ *
+ * \ingroup SCIFIO
+ */
+class SCIFIO_EXPORT SCIFIOSharedMemory
+{
+public:
+  /** Create and map a segment of the given size. Throws an
+   * itk::ExceptionObject if the segment cannot be created. */
+  explicit SCIFIOSharedMemory(size_t size);
+  ~SCIFIOSharedMemory();
+
+  SCIFIOSharedMemory(const SCIFIOSharedMemory &) = delete;
+  SCIFIOSharedMemory &
+  operator=(const SCIFIOSharedMemory &) = delete;
+
+  /** Whether shared memory segments can be created on this system. */
+  static bool
+  IsSupported();
+
+  void *
+  GetBuffer() const
+  {
+    return m_Buffer;
+  }
+
+  size_t
+  GetSize() const
+  {
+    return m_Size;
+  }
+
+  /** Path of the segment, as handed to the bridge. */
+  const std::string &
+  GetPath() const
+  {
+    return m_Path;
+  }
+
+private:
+  std::string m_Path;
+  void *      m_Buffer{ nullptr };
+  size_t      m_Size{ 0 };
+};
+} // end namespace itk
+
+#endif // itkSCIFIOSharedMemory_h
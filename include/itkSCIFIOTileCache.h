@@ -0,0 +1,121 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSCIFIOTileCache_h
+#define itkSCIFIOTileCache_h
+
+#include "SCIFIOExport.h"
+#include "itkIntTypes.h"
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class SCIFIOTileCache
+ *
+ * \brief Least recently used cache of image tiles read by SCIFIOImageIO.
+ *
+ * A tile is a rectangle of a single plane: the planes are the positions
+ * along the axes beyond X and Y (Z, T and C), and the rectangles a regular
+ * grid over X and Y. Tiles are identified by the file, series and
+ * resolution level they come from, and by the index of their first pixel.
+ * The file is identified by its name and its stamp, as returned by
+ * SCIFIOMetaDataCache::GetFileStamp(), so that the tiles of a file
+ * modified since they were read are not found anymore.
+ *
+ * The cache holds at most GetMaximumSize() bytes of pixel data; the least
+ * recently used tiles are evicted first.
+ *
+ * \ingroup SCIFIO
+ */
+class SCIFIO_EXPORT SCIFIOTileCache
+{
+public:
+  using BufferType = std::vector<char>;
+
+  struct KeyType
+  {
+    std::string                 FileName;
+    std::string                 FileStamp;
+    int                         Series;
+    int                         Resolution;
+    std::vector<IndexValueType> Index;
+
+    bool
+    operator<(const KeyType & other) const;
+  };
+
+  /** Return the tile, or nullptr if it is not cached. Counts a hit or a
+   * miss. The pointer is valid until the next call to Insert(). */
+  const BufferType *
+  Find(const KeyType & key);
+
+  /** Add a tile. Tiles larger than the whole cache are not kept. */
+  void
+  Insert(const KeyType & key, BufferType && tile);
+
+  /** Maximum number of bytes of pixel data held. Zero disables the cache. */
+  void
+  SetMaximumSize(size_t size);
+  size_t
+  GetMaximumSize() const
+  {
+    return m_MaximumSize;
+  }
+
+  /** Number of bytes of pixel data currently held. */
+  size_t
+  GetSize() const
+  {
+    return m_Size;
+  }
+
+  SizeValueType
+  GetNumberOfHits() const
+  {
+    return m_NumberOfHits;
+  }
+  SizeValueType
+  GetNumberOfMisses() const
+  {
+    return m_NumberOfMisses;
+  }
+
+  /** Drop all tiles. The counters are left alone. */
+  void
+  Clear();
+
+private:
+  using EntryType = std::pair<KeyType, BufferType>;
+  using ListType = std::list<EntryType>;
+
+  void
+  Evict(size_t maximumSize);
+
+  ListType                              m_Tiles;
+  std::map<KeyType, ListType::iterator> m_Index;
+  size_t                                m_MaximumSize{ 0 };
+  size_t                                m_Size{ 0 };
+  SizeValueType                         m_NumberOfHits{ 0 };
+  SizeValueType                         m_NumberOfMisses{ 0 };
+};
+} // end namespace itk
+
+#endif // itkSCIFIOTileCache_h
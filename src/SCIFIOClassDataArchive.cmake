@@ -0,0 +1,80 @@
+# Generate a class data sharing (AppCDS) archive of the classes the
+# SCIFIOITKBridge loads, so that each Java process started by SCIFIOImageIO
+# maps them instead of loading and verifying them from the JARs again.
+#
+# Usage:
+#   cmake -DJAVA_HOME=<jre> -DJAR_DIRECTORY=<jars> -P SCIFIOClassDataArchive.cmake
+#
+# The archive only matches the Java runtime and the JAR paths it was made
+# with, so it is made once for the build tree and once for the install
+# tree. Next to it, scifio-bridge.jsa.stamp records the Java home and the
+# class path it was made with; SCIFIOImageIO only uses the archive
+# when both match its own command line. Failing to make the archive is not
+# an error: the bridge then starts without it.
+
+string( REGEX REPLACE "/$" "" javaHome "${JAVA_HOME}" )
+if( CMAKE_HOST_WIN32 )
+  set( javaExecutable "${javaHome}/bin/java.exe" )
+  set( classPathSeparator ";" )
+else()
+  set( javaExecutable "${javaHome}/bin/java" )
+  set( classPathSeparator ":" )
+endif()
+if( NOT EXISTS "${javaExecutable}" )
+  message( STATUS "No Java runtime in ${javaHome}, not making a class data sharing archive" )
+  return()
+endif()
+
+string( REGEX REPLACE "/$" "" jarDirectory "${JAR_DIRECTORY}" )
+set( classPath "${jarDirectory}/bioformats_package.jar${classPathSeparator}${jarDirectory}/scifio-itk-bridge.jar" )
+set( archive "${jarDirectory}/scifio-bridge.jsa" )
+set( stamp "${archive}.stamp" )
+set( classList "${jarDirectory}/scifio-bridge.classlist" )
+
+# nothing to do if the archive is newer than the JARs
+if( EXISTS "${archive}" AND EXISTS "${stamp}"
+    AND "${archive}" IS_NEWER_THAN "${jarDirectory}/bioformats_package.jar"
+    AND "${archive}" IS_NEWER_THAN "${jarDirectory}/scifio-itk-bridge.jar" )
+  file( READ "${stamp}" previousStamp )
+  if( previousStamp STREQUAL "${javaHome}\n${classPath}\n" )
+    return()
+  endif()
+endif()
+file( REMOVE "${archive}" "${stamp}" )
+
+# record the classes loaded while the bridge probes and describes an image
+set( trainingFile "${jarDirectory}/scifio-bridge.training" )
+file( WRITE "${trainingFile}"
+  "canRead\tclassDataArchive&sizeX=64&sizeY=64.fake\n"
+  "info\tclassDataArchive&sizeX=64&sizeY=64.fake\n"
+  "seriesCount\n"
+  )
+execute_process(
+  COMMAND "${javaExecutable}" -Xshare:off -XX:DumpLoadedClassList=${classList}
+    -Djava.awt.headless=true -cp "${classPath}" io.scif.itk.SCIFIOITKBridge waitForInput
+  INPUT_FILE "${trainingFile}"
+  RESULT_VARIABLE result
+  OUTPUT_QUIET
+  ERROR_QUIET
+  )
+file( REMOVE "${trainingFile}" )
+if( NOT EXISTS "${classList}" )
+  message( WARNING "Could not list the classes of the SCIFIO bridge, not making a class data sharing archive" )
+  return()
+endif()
+
+execute_process(
+  COMMAND "${javaExecutable}" -Xshare:dump -XX:SharedClassListFile=${classList}
+    -XX:SharedArchiveFile=${archive} -cp "${classPath}"
+  RESULT_VARIABLE result
+  OUTPUT_VARIABLE output
+  ERROR_VARIABLE output
+  )
+file( REMOVE "${classList}" )
+if( NOT result EQUAL 0 OR NOT EXISTS "${archive}" )
+  message( WARNING "Could not make the class data sharing archive ${archive}:\n${output}" )
+  file( REMOVE "${archive}" )
+  return()
+endif()
+file( WRITE "${stamp}" "${javaHome}\n${classPath}\n" )
+message( STATUS "Made the class data sharing archive ${archive}" )
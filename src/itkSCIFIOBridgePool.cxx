@@ -0,0 +1,872 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOBridgePool.h"
+#include "itkMacro.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <mutex>
+
+#ifdef _WIN32
+#  include <io.h>
+#  include <fcntl.h>
+#  include <process.h>
+#else
+#  include <fcntl.h>
+#  include <poll.h>
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+namespace
+{
+std::string
+getEnv(const char * name)
+{
+  const char * result = itksys::SystemTools::GetEnv(name);
+  if (result == nullptr)
+  {
+    return "";
+  }
+  return result;
+}
+
+#ifndef _WIN32
+// Create a pipe whose ends are not inherited by processes spawned later;
+// the end given to the bridge is duplicated onto its stdout or stderr,
+// which clears the flag.
+bool
+createPipe(int pipeEnds[2])
+{
+  if (pipe(pipeEnds) != 0)
+  {
+    pipeEnds[0] = pipeEnds[1] = -1;
+    return false;
+  }
+  fcntl(pipeEnds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(pipeEnds[1], F_SETFD, FD_CLOEXEC);
+  return true;
+}
+
+void
+closePipe(int pipeEnds[2])
+{
+  for (int i = 0; i < 2; ++i)
+  {
+    if (pipeEnds[i] >= 0)
+    {
+      close(pipeEnds[i]);
+      pipeEnds[i] = -1;
+    }
+  }
+}
+#endif
+
+double
+getEnvNumber(const char * name, double defaultValue)
+{
+  const std::string value = getEnv(name);
+  if (value.empty())
+  {
+    return defaultValue;
+  }
+  return std::atof(value.c_str());
+}
+
+// Size in megabytes of an -Xmx<megabytes>m option, or 0 if arg is not one
+unsigned long long
+parseHeapSize(const std::string & arg)
+{
+  const std::string prefix = "-Xmx";
+  if (arg.size() < prefix.size() + 2 || arg.compare(0, prefix.size(), prefix) != 0 ||
+      (arg.back() != 'm' && arg.back() != 'M'))
+  {
+    return 0;
+  }
+  unsigned long long megabytes = 0;
+  for (size_t i = prefix.size(); i + 1 < arg.size(); ++i)
+  {
+    if (arg[i] < '0' || arg[i] > '9')
+    {
+      return 0;
+    }
+    megabytes = 10 * megabytes + (arg[i] - '0');
+  }
+  return megabytes;
+}
+
+// Join the arguments, with the size of the first -Xmx option left out and
+// returned in heapSize instead, so that command lines differing only in
+// heap size compare equal
+std::string
+joinCommandLine(const std::vector<std::string> & args, unsigned long long & heapSize)
+{
+  std::string commandLine;
+  heapSize = 0;
+  for (const auto & arg : args)
+  {
+    const unsigned long long megabytes = heapSize == 0 ? parseHeapSize(arg) : 0;
+    if (megabytes > 0)
+    {
+      heapSize = megabytes;
+      commandLine += "-Xmx";
+    }
+    else
+    {
+      commandLine += arg;
+    }
+    commandLine += '\n';
+  }
+  return commandLine;
+}
+
+std::string
+joinCommandLine(const std::vector<std::string> & args)
+{
+  unsigned long long heapSize;
+  return joinCommandLine(args, heapSize);
+}
+
+// Identify the bridge a command line runs by its classpath, so that
+// command lines differing only in JVM options, such as the heap size,
+// share the result of the capability negotiation.
+std::string
+bridgeKey(const std::vector<std::string> & args)
+{
+  const auto classpath = std::find(args.begin(), args.end(), "-cp");
+  if (classpath == args.end() || classpath + 1 == args.end())
+  {
+    return joinCommandLine(args);
+  }
+  return *(classpath + 1);
+}
+
+/*
+ * Shared state of the pool. Function-local so that it is constructed on
+ * first use, and torn down (killing idle workers) at process exit.
+ */
+class PoolState
+{
+public:
+  PoolState()
+    : m_MaximumNumberOfIdleWorkers(static_cast<unsigned int>(getEnvNumber("SCIFIO_POOL_SIZE", 4)))
+    , m_IdleTimeout(getEnvNumber("SCIFIO_POOL_IDLE_TIMEOUT", 300.0))
+    , m_NegotiationTimeout(getEnvNumber("SCIFIO_NEGOTIATION_TIMEOUT", 10.0))
+  {}
+
+  ~PoolState()
+  {
+    for (auto * worker : m_Idle)
+    {
+      SCIFIOBridgePool::Discard(worker);
+    }
+  }
+
+  std::mutex                      m_Mutex;
+  std::list<SCIFIOBridgeWorker *> m_Idle;
+  unsigned int                    m_MaximumNumberOfIdleWorkers;
+  double                          m_IdleTimeout;
+  double                          m_NegotiationTimeout;
+
+  // Result of the capability negotiation, per bridge: all workers started
+  // with the same classpath run the same bridge, so it only needs to be
+  // asked once per process. Legacy bridges are remembered with an empty
+  // set; bridges that did not answer in time are not remembered at all.
+  std::map<std::string, std::set<std::string>> m_Capabilities;
+};
+
+PoolState &
+GetPoolState()
+{
+  static PoolState state;
+  return state;
+}
+
+// Must be called with the pool mutex held. Expired workers are moved to
+// the given list so they can be terminated outside the lock.
+void
+ReapIdleWorkers(PoolState & state, std::list<SCIFIOBridgeWorker *> & expired)
+{
+  const auto now = SCIFIOBridgeWorker::ClockType::now();
+  for (auto it = state.m_Idle.begin(); it != state.m_Idle.end();)
+  {
+    const std::chrono::duration<double> idle = now - (*it)->LastUsed;
+    if (idle.count() > state.m_IdleTimeout)
+    {
+      expired.push_back(*it);
+      it = state.m_Idle.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+SCIFIOBridgeWorker *
+SpawnWorker(const std::vector<std::string> & args)
+{
+  auto * worker = new SCIFIOBridgeWorker;
+  worker->CommandLine = joinCommandLine(args, worker->HeapSize);
+
+#ifdef _WIN32
+  SECURITY_ATTRIBUTES saAttr;
+  saAttr.nLength = sizeof(SECURITY_ATTRIBUTES);
+  saAttr.bInheritHandle = TRUE;
+  saAttr.lpSecurityDescriptor = NULL;
+
+  if (!CreatePipe(&(worker->Pipe[0]), &(worker->Pipe[1]), &saAttr, 0))
+  {
+    delete worker;
+    itkGenericExceptionMacro(<< "createpipe() failed");
+  }
+  if (!SetHandleInformation(worker->Pipe[1], HANDLE_FLAG_INHERIT, 0))
+  {
+    delete worker;
+    itkGenericExceptionMacro(<< "set inherited failed");
+  }
+#else
+  const int pipeResult = pipe(worker->Pipe);
+  if (pipeResult != 0)
+  {
+    delete worker;
+    itkGenericExceptionMacro(<< "Error with SCIFIOImageIO pipe.");
+  }
+
+  // our own stdout and stderr pipes, see WaitForData
+  int outputPipe[2];
+  int errorPipe[2];
+  if (!createPipe(outputPipe) || !createPipe(errorPipe))
+  {
+    closePipe(outputPipe);
+    close(worker->Pipe[0]);
+    close(worker->Pipe[1]);
+    delete worker;
+    itkGenericExceptionMacro(<< "Error with SCIFIOImageIO pipe.");
+  }
+#  ifdef F_SETPIPE_SZ
+  // fewer, larger reads of the pixels; the system may refuse
+  fcntl(outputPipe[1], F_SETPIPE_SZ, 1 << 20);
+#  endif
+  // stdout is read without waiting first, stderr only once polled
+  fcntl(outputPipe[0], F_SETFL, fcntl(outputPipe[0], F_GETFL) | O_NONBLOCK);
+  worker->OutputBuffer.resize(64 * 1024);
+  worker->ErrorBuffer.resize(4 * 1024);
+#endif
+
+  std::vector<const char *> argv;
+  for (const auto & arg : args)
+  {
+    argv.push_back(arg.c_str());
+  }
+  argv.push_back(nullptr);
+
+  worker->Process = itksysProcess_New();
+  itksysProcess_SetCommand(worker->Process, argv.data());
+  itksysProcess_SetPipeNative(worker->Process, itksysProcess_Pipe_STDIN, worker->Pipe);
+#ifndef _WIN32
+  itksysProcess_SetPipeNative(worker->Process, itksysProcess_Pipe_STDOUT, outputPipe);
+  itksysProcess_SetPipeNative(worker->Process, itksysProcess_Pipe_STDERR, errorPipe);
+#endif
+
+  itksysProcess_Execute(worker->Process);
+
+#ifndef _WIN32
+  // only the bridge writes to them, so that we see the end of its output
+  // when it exits
+  close(outputPipe[1]);
+  close(errorPipe[1]);
+  worker->OutputPipe = outputPipe[0];
+  worker->ErrorPipe = errorPipe[0];
+#endif
+
+  std::string reason;
+  switch (itksysProcess_GetState(worker->Process))
+  {
+    case itksysProcess_State_Executing:
+      // this is the expected state
+      worker->LastUsed = SCIFIOBridgeWorker::ClockType::now();
+      return worker;
+    case itksysProcess_State_Exited:
+      reason = "exited with return value: " + std::to_string(itksysProcess_GetExitValue(worker->Process));
+      break;
+    case itksysProcess_State_Error:
+      reason = std::string("error:\n") + itksysProcess_GetErrorString(worker->Process);
+      break;
+    case itksysProcess_State_Exception:
+      reason = std::string("exception:\n") + itksysProcess_GetExceptionString(worker->Process);
+      break;
+    case itksysProcess_State_Expired:
+      reason = "internal error: expired.";
+      break;
+    case itksysProcess_State_Killed:
+      reason = "internal error: killed.";
+      break;
+    case itksysProcess_State_Disowned:
+      reason = "internal error: disowned.";
+      break;
+    default:
+      reason = "internal error: is in unknown state.";
+      break;
+  }
+  SCIFIOBridgePool::Discard(worker);
+  itkGenericExceptionMacro(<< "SCIFIOImageIO: SCIFIOITKBridge " << reason);
+}
+
+// Send a command to the bridge, without waiting for a reply.
+bool
+WriteCommand(SCIFIOBridgeWorker * worker, const std::string & command)
+{
+#ifdef _WIN32
+  DWORD bytesWritten;
+  return WriteFile(worker->Pipe[1], command.c_str(), command.size(), &bytesWritten, NULL) &&
+         bytesWritten == command.size();
+#else
+  return write(worker->Pipe[1], command.c_str(), command.size()) == static_cast<ssize_t>(command.size());
+#endif
+}
+
+// Swallow whatever the bridge already wrote, without waiting for more.
+void
+DiscardPendingOutput(SCIFIOBridgeWorker * worker)
+{
+  while (true)
+  {
+    char * data;
+    int    length;
+    double timeout = 0.0;
+    int    pipe = SCIFIOBridgePool::WaitForData(worker, &data, &length, &timeout);
+    if (pipe != itksysProcess_Pipe_STDOUT && pipe != itksysProcess_Pipe_STDERR)
+    {
+      return;
+    }
+  }
+}
+
+// Whether the last line of the text ends with a blank line and is true or
+// false, as the reply to "canWrite"
+bool
+EndsWithBooleanReply(const std::string & text)
+{
+  for (const std::string answer : { "true\n\n", "false\n\n" })
+  {
+    if (text.size() >= answer.size() && text.compare(text.size() - answer.size(), answer.size(), answer) == 0 &&
+        (text.size() == answer.size() || text[text.size() - answer.size() - 1] == '\n'))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Ask the bridge which protocol extensions it understands. A capable
+ * bridge replies with a "SCIFIOITKBridge <version>" line followed by one
+ * capability per line and a blank line. Older bridges do not know the
+ * command: they complain on stderr and/or answer with an empty line, in
+ * which case the worker is left with no capabilities.
+ *
+ * The question is followed by a "canWrite" of a made-up name, which all
+ * bridges answer with true or false and a blank line once they are done
+ * with the question, so that its reply marks the end of the answer. By
+ * then the bridge has written any complaint to stderr too, which is
+ * discarded without waiting for the bridge to fall silent.
+ *
+ * Returns whether the bridge answered: a bridge that complained about the
+ * question and exited did, and has no capabilities. Returns false if the
+ * bridge exited without a word, or did not get to the end of the answer
+ * within the given number of seconds, JVM startup included; the worker's
+ * output is then in an unknown state.
+ */
+bool
+NegotiateCapabilities(SCIFIOBridgeWorker * worker, double timeout)
+{
+  const std::string header = "SCIFIOITKBridge\t";
+
+  if (!WriteCommand(worker, "capabilities\ncanWrite\tscifio-negotiation\n"))
+  {
+    return false;
+  }
+
+  std::string reply;
+  std::string errors;
+  while (true)
+  {
+    char * data;
+    int    length;
+    int    pipe = SCIFIOBridgePool::WaitForData(worker, &data, &length, &timeout);
+    if (pipe == itksysProcess_Pipe_STDOUT)
+    {
+      reply.append(data, length);
+      // strip \r from Windows line endings
+      reply.erase(std::remove(reply.begin(), reply.end(), '\r'), reply.end());
+      if (!EndsWithBooleanReply(reply))
+      {
+        continue;
+      }
+      if (reply.compare(0, header.size(), header) == 0)
+      {
+        const size_t end = reply.find("\n\n");
+        size_t       p0 = reply.find('\n') + 1;
+        while (p0 < end)
+        {
+          const size_t p1 = reply.find('\n', p0);
+          if (p1 > p0)
+          {
+            worker->Capabilities.insert(reply.substr(p0, p1 - p0));
+          }
+          p0 = p1 + 1;
+        }
+      }
+      DiscardPendingOutput(worker);
+      return true;
+    }
+    else if (pipe == itksysProcess_Pipe_STDERR)
+    {
+      // the JVM and Bio-Formats may log unrelated warnings at startup
+      errors.append(data, length);
+    }
+    else if (pipe == itksysProcess_Pipe_Timeout)
+    {
+      return false;
+    }
+    else
+    {
+      // exited: a legacy bridge may give up on a command it does not know
+      return errors.find("capabilities") != std::string::npos ||
+             errors.find("Command failure") != std::string::npos ||
+             errors.find("Caught exception") != std::string::npos;
+    }
+  }
+}
+
+/*
+ * Turn on a protocol extension that changes the behavior of the bridge
+ * from then on, with the text command of the same name. The bridge
+ * acknowledges it with a text reply: the name and a blank line.
+ */
+bool
+EnableExtension(SCIFIOBridgeWorker * worker, const std::string & name)
+{
+  if (!WriteCommand(worker, name + "\n"))
+  {
+    return false;
+  }
+
+  std::string reply;
+  double      timeout = 60.0;
+  while (reply.find("\n\n") == std::string::npos)
+  {
+    char * data;
+    int    length;
+    int    pipe = SCIFIOBridgePool::WaitForData(worker, &data, &length, &timeout);
+    if (pipe == itksysProcess_Pipe_STDOUT)
+    {
+      reply.append(data, length);
+      reply.erase(std::remove(reply.begin(), reply.end(), '\r'), reply.end());
+    }
+    else if (pipe != itksysProcess_Pipe_STDERR)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+
+SCIFIOBridgeWorker *
+SCIFIOBridgePool::Lease(const std::vector<std::string> & args, unsigned long long maximumHeapSize)
+{
+  unsigned long long              heapSize;
+  const std::string               commandLine = joinCommandLine(args, heapSize);
+  const unsigned long long        largestHeapSize = std::max(heapSize, maximumHeapSize);
+  std::list<SCIFIOBridgeWorker *> unusable;
+  SCIFIOBridgeWorker *            leased = nullptr;
+  {
+    PoolState &                 state = GetPoolState();
+    std::lock_guard<std::mutex> lock(state.m_Mutex);
+    ReapIdleWorkers(state, unusable);
+    // most recently used workers are at the front
+    for (auto it = state.m_Idle.begin(); it != state.m_Idle.end(); ++it)
+    {
+      if ((*it)->CommandLine == commandLine && (*it)->HeapSize >= heapSize && (*it)->HeapSize <= largestHeapSize)
+      {
+        leased = *it;
+        state.m_Idle.erase(it);
+        break;
+      }
+    }
+  }
+
+  for (auto * worker : unusable)
+  {
+    Discard(worker);
+  }
+
+  if (leased != nullptr && !IsHealthy(leased))
+  {
+    Discard(leased);
+    leased = nullptr;
+  }
+
+  if (leased != nullptr)
+  {
+    return leased;
+  }
+
+  PoolState &       state = GetPoolState();
+  const std::string bridge = bridgeKey(args);
+  bool              negotiated = false;
+  double            negotiationTimeout;
+  {
+    std::lock_guard<std::mutex> lock(state.m_Mutex);
+    negotiated = state.m_Capabilities.count(bridge) > 0;
+    negotiationTimeout = state.m_NegotiationTimeout;
+  }
+
+  const auto spawnStart = SCIFIOBridgeWorker::ClockType::now();
+  leased = SpawnWorker(args);
+  if (!negotiated)
+  {
+    const bool extensions = getEnv("SCIFIO_BRIDGE_EXTENSIONS") != "0";
+    const bool answered = !extensions || NegotiateCapabilities(leased, negotiationTimeout);
+    if (!answered || !IsHealthy(leased))
+    {
+      // the bridge gave up on the question, or did not answer it in time:
+      // start over, with the text protocol unless it did answer
+      const std::set<std::string> capabilities = answered ? leased->Capabilities : std::set<std::string>();
+      Discard(leased);
+      leased = SpawnWorker(args);
+      leased->Capabilities = capabilities;
+    }
+    // a slow start is no answer, the next new worker is asked again
+    if (answered)
+    {
+      std::lock_guard<std::mutex> lock(state.m_Mutex);
+      state.m_Capabilities[bridge] = leased->Capabilities;
+    }
+  }
+  else
+  {
+    std::lock_guard<std::mutex> lock(state.m_Mutex);
+    leased->Capabilities = state.m_Capabilities[bridge];
+  }
+
+  if (leased->HasCapability("int64") && !EnableExtension(leased, "int64"))
+  {
+    Discard(leased);
+    itkGenericExceptionMacro(<< "SCIFIOImageIO: SCIFIOITKBridge did not acknowledge the switch to 64-bit integers");
+  }
+  // last, everything after it is framed
+  if (leased->HasCapability("binary"))
+  {
+    if (!EnableExtension(leased, "binary"))
+    {
+      Discard(leased);
+      itkGenericExceptionMacro(<< "SCIFIOImageIO: SCIFIOITKBridge did not acknowledge the switch to binary framing");
+    }
+    leased->BinaryFraming = true;
+  }
+  leased->SpawnSeconds = std::chrono::duration<double>(SCIFIOBridgeWorker::ClockType::now() - spawnStart).count();
+  return leased;
+}
+
+
+void
+SCIFIOBridgePool::Release(SCIFIOBridgeWorker * worker)
+{
+  if (worker == nullptr)
+  {
+    return;
+  }
+  if (!IsHealthy(worker))
+  {
+    Discard(worker);
+    return;
+  }
+
+  worker->LastUsed = SCIFIOBridgeWorker::ClockType::now();
+
+  std::list<SCIFIOBridgeWorker *> unusable;
+  {
+    PoolState &                 state = GetPoolState();
+    std::lock_guard<std::mutex> lock(state.m_Mutex);
+    ReapIdleWorkers(state, unusable);
+    state.m_Idle.push_front(worker);
+    while (state.m_Idle.size() > state.m_MaximumNumberOfIdleWorkers)
+    {
+      unusable.push_back(state.m_Idle.back());
+      state.m_Idle.pop_back();
+    }
+  }
+
+  for (auto * expired : unusable)
+  {
+    Discard(expired);
+  }
+}
+
+
+void
+SCIFIOBridgePool::Discard(SCIFIOBridgeWorker * worker)
+{
+  if (worker == nullptr)
+  {
+    return;
+  }
+
+  if (worker->Process != nullptr)
+  {
+    if (itksysProcess_GetState(worker->Process) == itksysProcess_State_Executing)
+    {
+      itksysProcess_Kill(worker->Process);
+      itksysProcess_WaitForExit(worker->Process, nullptr);
+    }
+    itksysProcess_Delete(worker->Process);
+
+#ifdef _WIN32
+    CloseHandle(worker->Pipe[0]);
+    CloseHandle(worker->Pipe[1]);
+#else
+    close(worker->Pipe[0]);
+    close(worker->Pipe[1]);
+    int outputPipes[2] = { worker->OutputPipe, worker->ErrorPipe };
+    closePipe(outputPipes);
+#endif
+  }
+  delete worker;
+}
+
+
+int
+SCIFIOBridgePool::WaitForData(SCIFIOBridgeWorker * worker,
+                              char **              data,
+                              int *                length,
+                              double *             timeout,
+                              char *               destination,
+                              size_t               capacity)
+{
+#ifdef _WIN32
+  return itksysProcess_WaitForData(worker->Process, data, length, timeout);
+#else
+  if (worker->OutputPipe < 0 && worker->ErrorPipe < 0)
+  {
+    return itksysProcess_Pipe_None;
+  }
+  if (destination == nullptr || capacity == 0)
+  {
+    destination = worker->OutputBuffer.data();
+    capacity = worker->OutputBuffer.size();
+  }
+  capacity = std::min<size_t>(capacity, INT_MAX);
+
+  const auto deadline =
+    SCIFIOBridgeWorker::ClockType::now() + std::chrono::duration<double>(timeout != nullptr ? *timeout : 0.0);
+  while (true)
+  {
+    // while the bridge is streaming pixels, stdout is ready more often
+    // than not: try it first, and only poll when it runs dry
+    if (worker->OutputPipe >= 0)
+    {
+      const ssize_t bytesRead = read(worker->OutputPipe, destination, capacity);
+      if (bytesRead > 0)
+      {
+        *data = destination;
+        *length = static_cast<int>(bytesRead);
+        return itksysProcess_Pipe_STDOUT;
+      }
+      if (bytesRead == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+      {
+        close(worker->OutputPipe);
+        worker->OutputPipe = -1;
+        continue;
+      }
+    }
+
+    struct pollfd fds[2];
+    nfds_t        count = 0;
+    for (const int fd : { worker->OutputPipe, worker->ErrorPipe })
+    {
+      if (fd >= 0)
+      {
+        fds[count].fd = fd;
+        fds[count].events = POLLIN;
+        fds[count].revents = 0;
+        ++count;
+      }
+    }
+    if (count == 0)
+    {
+      return itksysProcess_Pipe_None;
+    }
+
+    int milliseconds = -1;
+    if (timeout != nullptr)
+    {
+      const std::chrono::duration<double> left = deadline - SCIFIOBridgeWorker::ClockType::now();
+      milliseconds = static_cast<int>(std::max(0.0, std::ceil(left.count() * 1000.0)));
+    }
+    const int ready = poll(fds, count, milliseconds);
+    if (ready < 0 && errno != EINTR)
+    {
+      return itksysProcess_Pipe_None;
+    }
+    if (ready == 0)
+    {
+      *timeout = 0.0;
+      return itksysProcess_Pipe_Timeout;
+    }
+    if (timeout != nullptr)
+    {
+      *timeout = std::max(0.0, std::chrono::duration<double>(deadline - SCIFIOBridgeWorker::ClockType::now()).count());
+    }
+
+    if (worker->ErrorPipe >= 0 && fds[count - 1].fd == worker->ErrorPipe && fds[count - 1].revents != 0)
+    {
+      const ssize_t bytesRead = read(worker->ErrorPipe, worker->ErrorBuffer.data(), worker->ErrorBuffer.size());
+      if (bytesRead > 0)
+      {
+        *data = worker->ErrorBuffer.data();
+        *length = static_cast<int>(bytesRead);
+        return itksysProcess_Pipe_STDERR;
+      }
+      if (bytesRead == 0 || errno != EINTR)
+      {
+        close(worker->ErrorPipe);
+        worker->ErrorPipe = -1;
+      }
+    }
+  }
+#endif
+}
+
+
+bool
+SCIFIOBridgePool::IsHealthy(SCIFIOBridgeWorker * worker)
+{
+  if (worker == nullptr || worker->Process == nullptr ||
+      itksysProcess_GetState(worker->Process) != itksysProcess_State_Executing)
+  {
+    return false;
+  }
+  // Poll without blocking: the bridge only talks when asked, so nothing of
+  // value is discarded, and an exited JVM is noticed here rather than on
+  // the next command.
+  double timeout = 0.0;
+  return itksysProcess_WaitForExit(worker->Process, &timeout) == 0;
+}
+
+
+void
+SCIFIOBridgePool::SetMaximumNumberOfIdleWorkers(unsigned int number)
+{
+  std::list<SCIFIOBridgeWorker *> unusable;
+  {
+    PoolState &                 state = GetPoolState();
+    std::lock_guard<std::mutex> lock(state.m_Mutex);
+    state.m_MaximumNumberOfIdleWorkers = number;
+    while (state.m_Idle.size() > number)
+    {
+      unusable.push_back(state.m_Idle.back());
+      state.m_Idle.pop_back();
+    }
+  }
+  for (auto * worker : unusable)
+  {
+    Discard(worker);
+  }
+}
+
+
+unsigned int
+SCIFIOBridgePool::GetMaximumNumberOfIdleWorkers()
+{
+  PoolState &                 state = GetPoolState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  return state.m_MaximumNumberOfIdleWorkers;
+}
+
+
+void
+SCIFIOBridgePool::SetIdleTimeout(double seconds)
+{
+  PoolState &                 state = GetPoolState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  state.m_IdleTimeout = seconds;
+}
+
+
+double
+SCIFIOBridgePool::GetIdleTimeout()
+{
+  PoolState &                 state = GetPoolState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  return state.m_IdleTimeout;
+}
+
+
+void
+SCIFIOBridgePool::SetNegotiationTimeout(double seconds)
+{
+  PoolState &                 state = GetPoolState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  state.m_NegotiationTimeout = seconds;
+}
+
+
+double
+SCIFIOBridgePool::GetNegotiationTimeout()
+{
+  PoolState &                 state = GetPoolState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  return state.m_NegotiationTimeout;
+}
+
+
+unsigned int
+SCIFIOBridgePool::GetNumberOfIdleWorkers()
+{
+  PoolState &                 state = GetPoolState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  return static_cast<unsigned int>(state.m_Idle.size());
+}
+
+
+void
+SCIFIOBridgePool::Clear()
+{
+  std::list<SCIFIOBridgeWorker *> unusable;
+  {
+    PoolState &                 state = GetPoolState();
+    std::lock_guard<std::mutex> lock(state.m_Mutex);
+    unusable.swap(state.m_Idle);
+  }
+  for (auto * worker : unusable)
+  {
+    Discard(worker);
+  }
+}
+} // end namespace itk
@@ -0,0 +1,332 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOBridgeProtocol.h"
+#include "itkMacro.h"
+
+#include <cstring>
+#include <sstream>
+
+namespace itk
+{
+namespace
+{
+template <typename T>
+void
+appendLittleEndian(std::string & out, T value, unsigned int bytes = sizeof(T))
+{
+  const auto raw = static_cast<uint64_t>(value);
+  for (unsigned int i = 0; i < bytes; ++i)
+  {
+    out += static_cast<char>((raw >> (8 * i)) & 0xff);
+  }
+}
+
+uint64_t
+readLittleEndian(const char * in, unsigned int bytes)
+{
+  uint64_t value = 0;
+  for (unsigned int i = 0; i < bytes; ++i)
+  {
+    value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+  }
+  return value;
+}
+
+// Cursor over a payload that refuses to read past its end
+class PayloadReader
+{
+public:
+  PayloadReader(const char * data, size_t length)
+    : m_Data(data)
+    , m_Length(length)
+  {}
+
+  bool
+  AtEnd() const
+  {
+    return m_Position >= m_Length;
+  }
+
+  const char *
+  Take(size_t bytes)
+  {
+    if (bytes > m_Length - m_Position)
+    {
+      itkGenericExceptionMacro(<< "SCIFIOBridgeProtocol: truncated payload");
+    }
+    const char * current = m_Data + m_Position;
+    m_Position += bytes;
+    return current;
+  }
+
+private:
+  const char * m_Data;
+  size_t       m_Length;
+  size_t       m_Position{ 0 };
+};
+} // namespace
+
+
+std::string
+SCIFIOBridgeField::ToString() const
+{
+  std::ostringstream oss;
+  switch (m_Type)
+  {
+    case TypeEnum::String:
+      return m_String;
+    case TypeEnum::Int64:
+      oss << m_Int64;
+      break;
+    case TypeEnum::Double:
+      oss << m_Double;
+      break;
+    case TypeEnum::Bool:
+      oss << (m_Bool ? 1 : 0);
+      break;
+  }
+  return oss.str();
+}
+
+
+int64_t
+SCIFIOBridgeField::ToInt64() const
+{
+  switch (m_Type)
+  {
+    case TypeEnum::Int64:
+      return m_Int64;
+    case TypeEnum::Double:
+      return static_cast<int64_t>(m_Double);
+    case TypeEnum::Bool:
+      return m_Bool ? 1 : 0;
+    case TypeEnum::String:
+    default:
+      break;
+  }
+  int64_t value;
+  if (!(std::istringstream(m_String) >> value))
+  {
+    itkGenericExceptionMacro(<< "SCIFIOImageIO: error while converting: " << m_String);
+  }
+  return value;
+}
+
+
+double
+SCIFIOBridgeField::ToDouble() const
+{
+  switch (m_Type)
+  {
+    case TypeEnum::Double:
+      return m_Double;
+    case TypeEnum::Int64:
+      return static_cast<double>(m_Int64);
+    case TypeEnum::Bool:
+      return m_Bool ? 1.0 : 0.0;
+    case TypeEnum::String:
+    default:
+      break;
+  }
+  double value;
+  if (!(std::istringstream(m_String) >> value))
+  {
+    itkGenericExceptionMacro(<< "SCIFIOImageIO: error while converting: " << m_String);
+  }
+  return value;
+}
+
+
+bool
+SCIFIOBridgeField::ToBool() const
+{
+  switch (m_Type)
+  {
+    case TypeEnum::Bool:
+      return m_Bool;
+    case TypeEnum::Int64:
+      return m_Int64 != 0;
+    case TypeEnum::Double:
+      return m_Double != 0.0;
+    case TypeEnum::String:
+    default:
+      break;
+  }
+  // accept both 0/1 and false/true
+  std::istringstream iss(m_String);
+  bool               value = false;
+  iss >> value;
+  if (iss.fail())
+  {
+    iss.clear();
+    iss >> std::boolalpha >> value;
+  }
+  return value;
+}
+
+
+std::string
+SCIFIOBridgeProtocol::EncodeHeader(MessageEnum type, uint32_t requestId, uint64_t payloadLength)
+{
+  std::string header;
+  header.reserve(HeaderLength);
+  appendLittleEndian(header, Magic);
+  appendLittleEndian(header, Version);
+  appendLittleEndian(header, static_cast<uint16_t>(type));
+  appendLittleEndian(header, requestId);
+  appendLittleEndian(header, payloadLength);
+  return header;
+}
+
+
+std::string
+SCIFIOBridgeProtocol::EncodeFrame(MessageEnum type, uint32_t requestId, const SCIFIOBridgeFields & fields)
+{
+  std::string payload;
+  for (const auto & field : fields)
+  {
+    payload += static_cast<char>(field.GetType());
+    switch (field.GetType())
+    {
+      case SCIFIOBridgeField::TypeEnum::String:
+      {
+        const std::string value = field.ToString();
+        appendLittleEndian(payload, static_cast<uint32_t>(value.size()));
+        payload += value;
+        break;
+      }
+      case SCIFIOBridgeField::TypeEnum::Int64:
+        appendLittleEndian(payload, field.ToInt64());
+        break;
+      case SCIFIOBridgeField::TypeEnum::Double:
+      {
+        const double value = field.ToDouble();
+        uint64_t     bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        appendLittleEndian(payload, bits);
+        break;
+      }
+      case SCIFIOBridgeField::TypeEnum::Bool:
+        payload += static_cast<char>(field.ToBool() ? 1 : 0);
+        break;
+    }
+  }
+  return EncodeHeader(type, requestId, payload.size()) + payload;
+}
+
+
+SCIFIOBridgeProtocol::FrameHeader
+SCIFIOBridgeProtocol::DecodeHeader(const char * header)
+{
+  if (readLittleEndian(header, 4) != Magic)
+  {
+    itkGenericExceptionMacro(<< "SCIFIOBridgeProtocol: bad frame magic");
+  }
+  const auto version = static_cast<uint16_t>(readLittleEndian(header + 4, 2));
+  if (version != Version)
+  {
+    itkGenericExceptionMacro(<< "SCIFIOBridgeProtocol: unsupported protocol version " << version);
+  }
+  FrameHeader frame;
+  frame.Type = static_cast<MessageEnum>(readLittleEndian(header + 6, 2));
+  frame.RequestId = static_cast<uint32_t>(readLittleEndian(header + 8, 4));
+  frame.PayloadLength = readLittleEndian(header + 12, 8);
+  return frame;
+}
+
+
+SCIFIOBridgeFields
+SCIFIOBridgeProtocol::DecodeFields(const char * payload, size_t length)
+{
+  SCIFIOBridgeFields fields;
+  PayloadReader      reader(payload, length);
+  while (!reader.AtEnd())
+  {
+    const auto type = static_cast<SCIFIOBridgeField::TypeEnum>(*reader.Take(1));
+    switch (type)
+    {
+      case SCIFIOBridgeField::TypeEnum::String:
+      {
+        const auto stringLength = static_cast<size_t>(readLittleEndian(reader.Take(4), 4));
+        fields.emplace_back(std::string(reader.Take(stringLength), stringLength));
+        break;
+      }
+      case SCIFIOBridgeField::TypeEnum::Int64:
+        fields.emplace_back(static_cast<long long>(readLittleEndian(reader.Take(8), 8)));
+        break;
+      case SCIFIOBridgeField::TypeEnum::Double:
+      {
+        const uint64_t bits = readLittleEndian(reader.Take(8), 8);
+        double         value;
+        std::memcpy(&value, &bits, sizeof(value));
+        fields.emplace_back(value);
+        break;
+      }
+      case SCIFIOBridgeField::TypeEnum::Bool:
+        fields.emplace_back(*reader.Take(1) != 0);
+        break;
+      default:
+        itkGenericExceptionMacro(<< "SCIFIOBridgeProtocol: unknown field type " << static_cast<int>(type));
+    }
+  }
+  return fields;
+}
+
+
+std::string
+SCIFIOBridgeProtocol::EncodeTextCommand(const SCIFIOBridgeFields & fields)
+{
+  std::string command;
+  for (size_t i = 0; i < fields.size(); ++i)
+  {
+    if (i > 0)
+    {
+      command += '\t';
+    }
+    command += fields[i].ToString();
+  }
+  command += '\n';
+  return command;
+}
+
+
+SCIFIOBridgeFields
+SCIFIOBridgeProtocol::DecodeTextReply(const std::string & reply)
+{
+  // one value per line; the trailing empty line only marks the end
+  size_t end = reply.size();
+  while (end > 0 && reply[end - 1] == '\n')
+  {
+    --end;
+  }
+
+  SCIFIOBridgeFields fields;
+  size_t             p0 = 0;
+  while (p0 < end)
+  {
+    size_t p1 = reply.find('\n', p0);
+    if (p1 == std::string::npos || p1 > end)
+    {
+      p1 = end;
+    }
+    fields.emplace_back(reply.substr(p0, p1 - p0));
+    p0 = p1 + 1;
+  }
+  return fields;
+}
+} // end namespace itk
@@ -0,0 +1,158 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOBridgeStatistics.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+
+namespace itk
+{
+namespace
+{
+double
+throughput(unsigned long long bytes, double seconds)
+{
+  return seconds > 0.0 ? static_cast<double>(bytes) / seconds : 0.0;
+}
+
+/*
+ * Process-wide totals, printed at exit if SCIFIO_BRIDGE_STATISTICS is 1.
+ */
+class TotalsState
+{
+public:
+  ~TotalsState()
+  {
+    const char * print = itksys::SystemTools::GetEnv("SCIFIO_BRIDGE_STATISTICS");
+    if (print != nullptr && std::string(print) == "1")
+    {
+      m_Totals.Print(std::cerr);
+    }
+  }
+
+  std::mutex             m_Mutex;
+  SCIFIOBridgeStatistics m_Totals;
+};
+
+TotalsState &
+GetTotalsState()
+{
+  static TotalsState state;
+  return state;
+}
+} // namespace
+
+
+double
+SCIFIOBridgeStatistics::GetReceiveThroughput() const
+{
+  return throughput(BytesReceived, ReceiveSeconds);
+}
+
+
+double
+SCIFIOBridgeStatistics::GetSendThroughput() const
+{
+  return throughput(BytesSent, SendSeconds);
+}
+
+
+void
+SCIFIOBridgeStatistics::AddCommand(const std::string & name, double seconds)
+{
+  CommandStatistics & command = Commands[name];
+  ++command.Count;
+  command.TotalSeconds += seconds;
+  command.MaximumSeconds = std::max(command.MaximumSeconds, seconds);
+}
+
+
+void
+SCIFIOBridgeStatistics::Merge(const SCIFIOBridgeStatistics & other)
+{
+  NumberOfSpawns += other.NumberOfSpawns;
+  SpawnSeconds += other.SpawnSeconds;
+  for (const auto & entry : other.Commands)
+  {
+    CommandStatistics & command = Commands[entry.first];
+    command.Count += entry.second.Count;
+    command.TotalSeconds += entry.second.TotalSeconds;
+    command.MaximumSeconds = std::max(command.MaximumSeconds, entry.second.MaximumSeconds);
+  }
+  BytesReceived += other.BytesReceived;
+  ChunksReceived += other.ChunksReceived;
+  ReceiveSeconds += other.ReceiveSeconds;
+  BytesReceivedInPlace += other.BytesReceivedInPlace;
+  BytesSent += other.BytesSent;
+  ChunksSent += other.ChunksSent;
+  SendSeconds += other.SendSeconds;
+  SharedMemoryBytes += other.SharedMemoryBytes;
+  StderrBytes += other.StderrBytes;
+  StderrChunks += other.StderrChunks;
+}
+
+
+void
+SCIFIOBridgeStatistics::Print(std::ostream & os) const
+{
+  os << "SCIFIO bridge statistics" << std::endl;
+  os << "  Java processes started: " << NumberOfSpawns << " in " << SpawnSeconds << " s" << std::endl;
+  for (const auto & entry : Commands)
+  {
+    const CommandStatistics & command = entry.second;
+    os << "  " << entry.first << ": " << command.Count << " calls, " << command.TotalSeconds << " s total, "
+       << command.TotalSeconds / command.Count << " s mean, " << command.MaximumSeconds << " s max" << std::endl;
+  }
+  os << "  Received: " << BytesReceived << " bytes in " << ChunksReceived << " chunks, " << ReceiveSeconds << " s, "
+     << GetReceiveThroughput() / (1024 * 1024) << " MiB/s, " << BytesReceivedInPlace << " bytes in place"
+     << std::endl;
+  os << "  Sent: " << BytesSent << " bytes in " << ChunksSent << " chunks, " << SendSeconds << " s, "
+     << GetSendThroughput() / (1024 * 1024) << " MiB/s" << std::endl;
+  os << "  Shared memory: " << SharedMemoryBytes << " bytes" << std::endl;
+  os << "  Stderr: " << StderrBytes << " bytes in " << StderrChunks << " chunks" << std::endl;
+}
+
+
+SCIFIOBridgeStatistics
+SCIFIOBridgeStatistics::GetProcessTotals()
+{
+  TotalsState &               state = GetTotalsState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  return state.m_Totals;
+}
+
+
+void
+SCIFIOBridgeStatistics::AddToProcessTotals(const SCIFIOBridgeStatistics & statistics)
+{
+  TotalsState &               state = GetTotalsState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  state.m_Totals.Merge(statistics);
+}
+
+
+void
+SCIFIOBridgeStatistics::ResetProcessTotals()
+{
+  TotalsState &               state = GetTotalsState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  state.m_Totals = SCIFIOBridgeStatistics();
+}
+} // end namespace itk
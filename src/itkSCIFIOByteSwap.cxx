@@ -0,0 +1,299 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOByteSwap.h"
+
+#include <atomic>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define SCIFIO_BYTE_SWAP_SSE2
+#  include <emmintrin.h>
+#  if defined(_MSC_VER)
+#    define SCIFIO_BYTE_SWAP_AVX2
+#    define SCIFIO_TARGET_AVX2
+#    include <immintrin.h>
+#    include <intrin.h>
+#  elif defined(__GNUC__) || defined(__clang__)
+// compiled for AVX2 whatever the flags, and only run where it is supported
+#    define SCIFIO_BYTE_SWAP_AVX2
+#    define SCIFIO_TARGET_AVX2 __attribute__((target("avx2")))
+#    include <immintrin.h>
+#  endif
+#endif
+
+namespace itk
+{
+namespace
+{
+using InstructionSetEnum = SCIFIOByteSwap::InstructionSetEnum;
+
+inline uint16_t
+swapBytes(uint16_t value)
+{
+  return static_cast<uint16_t>((value >> 8) | (value << 8));
+}
+
+inline uint32_t
+swapBytes(uint32_t value)
+{
+  return ((value & 0xffU) << 24) | ((value & 0xff00U) << 8) | ((value >> 8) & 0xff00U) | (value >> 24);
+}
+
+inline uint64_t
+swapBytes(uint64_t value)
+{
+  return (static_cast<uint64_t>(swapBytes(static_cast<uint32_t>(value))) << 32) |
+         swapBytes(static_cast<uint32_t>(value >> 32));
+}
+
+template <typename T>
+void
+swapScalar(char * destination, const char * source, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    T value;
+    memcpy(&value, source + i * sizeof(T), sizeof(T));
+    value = swapBytes(value);
+    memcpy(destination + i * sizeof(T), &value, sizeof(T));
+  }
+}
+
+#ifdef SCIFIO_BYTE_SWAP_SSE2
+// SSE2 has no byte shuffle: swap the 16-bit words of each component, then
+// the bytes of each word
+template <typename T>
+__m128i
+swapVector(__m128i value);
+
+template <>
+inline __m128i
+swapVector<uint16_t>(__m128i value)
+{
+  return _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+}
+
+template <>
+inline __m128i
+swapVector<uint32_t>(__m128i value)
+{
+  value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+  value = _mm_shufflehi_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+  return swapVector<uint16_t>(value);
+}
+
+template <>
+inline __m128i
+swapVector<uint64_t>(__m128i value)
+{
+  value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+  value = _mm_shufflehi_epi16(value, _MM_SHUFFLE(0, 1, 2, 3));
+  return swapVector<uint16_t>(value);
+}
+
+template <typename T>
+void
+swapSSE2(char * destination, const char * source, size_t count)
+{
+  constexpr size_t perVector = sizeof(__m128i) / sizeof(T);
+  size_t           i = 0;
+  for (; i + perVector <= count; i += perVector)
+  {
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * sizeof(T)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i * sizeof(T)), swapVector<T>(value));
+  }
+  swapScalar<T>(destination + i * sizeof(T), source + i * sizeof(T), count - i);
+}
+#endif
+
+#ifdef SCIFIO_BYTE_SWAP_AVX2
+template <typename T>
+SCIFIO_TARGET_AVX2 void
+swapAVX2(char * destination, const char * source, size_t count)
+{
+  // the shuffle works within each 128-bit lane
+  alignas(32) char order[sizeof(__m256i)];
+  for (unsigned int b = 0; b < sizeof(order); ++b)
+  {
+    order[b] = static_cast<char>((b - b % sizeof(T) + sizeof(T) - 1 - b % sizeof(T)) % 16);
+  }
+  const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i *>(order));
+
+  constexpr size_t perVector = sizeof(__m256i) / sizeof(T);
+  size_t           i = 0;
+  for (; i + perVector <= count; i += perVector)
+  {
+    const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + i * sizeof(T)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i * sizeof(T)), _mm256_shuffle_epi8(value, mask));
+  }
+  swapSSE2<T>(destination + i * sizeof(T), source + i * sizeof(T), count - i);
+}
+
+bool
+processorHasAVX2()
+{
+#  if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+  {
+    return false;
+  }
+  // the operating system must also save the AVX registers
+  __cpuid(info, 1);
+  const bool avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+  if (!avx || (_xgetbv(0) & 6) != 6)
+  {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#  else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#  endif
+}
+#endif
+
+InstructionSetEnum
+bestInstructionSet()
+{
+#if defined(SCIFIO_BYTE_SWAP_AVX2)
+  if (processorHasAVX2())
+  {
+    return InstructionSetEnum::AVX2;
+  }
+#endif
+#if defined(SCIFIO_BYTE_SWAP_SSE2)
+  return InstructionSetEnum::SSE2;
+#else
+  return InstructionSetEnum::SCALAR;
+#endif
+}
+
+std::atomic<InstructionSetEnum> &
+currentInstructionSet()
+{
+  static std::atomic<InstructionSetEnum> instructionSet(bestInstructionSet());
+  return instructionSet;
+}
+
+template <typename T>
+void
+swapRange(void * destination, const void * source, size_t count)
+{
+  char *       to = static_cast<char *>(destination);
+  const char * from = static_cast<const char *>(source);
+  switch (currentInstructionSet().load(std::memory_order_relaxed))
+  {
+#ifdef SCIFIO_BYTE_SWAP_AVX2
+    case InstructionSetEnum::AVX2:
+      swapAVX2<T>(to, from, count);
+      break;
+#endif
+#ifdef SCIFIO_BYTE_SWAP_SSE2
+    case InstructionSetEnum::SSE2:
+      swapSSE2<T>(to, from, count);
+      break;
+#endif
+    default:
+      swapScalar<T>(to, from, count);
+  }
+}
+} // namespace
+
+
+void
+SCIFIOByteSwap::CopySwapRange(void * destination, const void * source, size_t componentSize, size_t count)
+{
+  switch (componentSize)
+  {
+    case 2:
+      swapRange<uint16_t>(destination, source, count);
+      break;
+    case 4:
+      swapRange<uint32_t>(destination, source, count);
+      break;
+    case 8:
+      swapRange<uint64_t>(destination, source, count);
+      break;
+    default:
+      if (destination != source)
+      {
+        memcpy(destination, source, componentSize * count);
+      }
+  }
+}
+
+
+void
+SCIFIOByteSwap::SwapRange(void * buffer, size_t componentSize, size_t count)
+{
+  CopySwapRange(buffer, buffer, componentSize, count);
+}
+
+
+bool
+SCIFIOByteSwap::IsSystemLittleEndian()
+{
+  const uint16_t one = 1;
+  unsigned char  first;
+  memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+
+SCIFIOByteSwap::InstructionSetEnum
+SCIFIOByteSwap::GetInstructionSet()
+{
+  return currentInstructionSet().load();
+}
+
+
+bool
+SCIFIOByteSwap::SetInstructionSet(InstructionSetEnum instructionSet)
+{
+  if (!IsInstructionSetSupported(instructionSet))
+  {
+    return false;
+  }
+  currentInstructionSet().store(instructionSet);
+  return true;
+}
+
+
+bool
+SCIFIOByteSwap::IsInstructionSetSupported(InstructionSetEnum instructionSet)
+{
+  switch (instructionSet)
+  {
+    case InstructionSetEnum::SCALAR:
+      return true;
+#ifdef SCIFIO_BYTE_SWAP_SSE2
+    case InstructionSetEnum::SSE2:
+      return true;
+#endif
+#ifdef SCIFIO_BYTE_SWAP_AVX2
+    case InstructionSetEnum::AVX2:
+      return processorHasAVX2();
+#endif
+    default:
+      return false;
+  }
+}
+} // end namespace itk
@@ -0,0 +1,137 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOCoreMetaData.h"
+#include "itkMacro.h"
+
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace itk
+{
+namespace
+{
+template <typename T>
+void
+parseField(const std::string & key, const std::string & value, T & field)
+{
+  if (!(std::istringstream(value) >> field))
+  {
+    itkGenericExceptionMacro(<< "SCIFIOCoreMetaData: error while converting " << key << ": " << value);
+  }
+}
+
+// accept both 0/1 and false/true
+void
+parseField(const std::string & itkNotUsed(key), const std::string & value, bool & field)
+{
+  std::istringstream iss(value);
+  iss >> field;
+  if (iss.fail())
+  {
+    iss.clear();
+    iss >> std::boolalpha >> field;
+  }
+}
+} // namespace
+
+
+void
+SCIFIOCoreMetaData::Parse(const EntryType & entries)
+{
+  const std::map<std::string, SizeValueType *> sizes{
+    { "SizeX", &SizeX }, { "SizeY", &SizeY }, { "SizeZ", &SizeZ }, { "SizeT", &SizeT }, { "SizeC", &SizeC }
+  };
+  const std::map<std::string, double *> spacings{ { "PixelsPhysicalSizeX", &PhysicalSizeX },
+                                                  { "PixelsPhysicalSizeY", &PhysicalSizeY },
+                                                  { "PixelsPhysicalSizeZ", &PhysicalSizeZ },
+                                                  { "PixelsPhysicalSizeT", &PhysicalSizeT },
+                                                  { "PixelsPhysicalSizeC", &PhysicalSizeC } };
+
+  for (const auto & entry : entries)
+  {
+    const auto size = sizes.find(entry.first);
+    const auto spacing = spacings.find(entry.first);
+    if (size != sizes.end())
+    {
+      parseField(entry.first, entry.second, *size->second);
+    }
+    else if (spacing != spacings.end())
+    {
+      parseField(entry.first, entry.second, *spacing->second);
+    }
+    else if (entry.first == "PixelType")
+    {
+      parseField(entry.first, entry.second, PixelType);
+    }
+    else if (entry.first == "RGBChannelCount")
+    {
+      parseField(entry.first, entry.second, RGBChannelCount);
+    }
+    else if (entry.first == "Interleaved")
+    {
+      parseField(entry.first, entry.second, Interleaved);
+    }
+    else if (entry.first == "LittleEndian")
+    {
+      parseField(entry.first, entry.second, LittleEndian);
+    }
+    else if (entry.first == "ResolutionCount")
+    {
+      parseField(entry.first, entry.second, ResolutionCount);
+    }
+    else if (entry.first == "OptimalTileWidth")
+    {
+      parseField(entry.first, entry.second, OptimalTileWidth);
+    }
+    else if (entry.first == "OptimalTileHeight")
+    {
+      parseField(entry.first, entry.second, OptimalTileHeight);
+    }
+    else if (entry.first == "SeriesName")
+    {
+      Name = entry.second;
+    }
+  }
+}
+
+
+bool
+SCIFIOCoreMetaData::IsCoreKey(const std::string & key)
+{
+  static const std::set<std::string> coreKeys{ "SizeX",
+                                               "SizeY",
+                                               "SizeZ",
+                                               "SizeT",
+                                               "SizeC",
+                                               "PixelsPhysicalSizeX",
+                                               "PixelsPhysicalSizeY",
+                                               "PixelsPhysicalSizeZ",
+                                               "PixelsPhysicalSizeT",
+                                               "PixelsPhysicalSizeC",
+                                               "PixelType",
+                                               "RGBChannelCount",
+                                               "Interleaved",
+                                               "LittleEndian",
+                                               "ResolutionCount",
+                                               "OptimalTileWidth",
+                                               "OptimalTileHeight",
+                                               "SeriesName" };
+  return coreKeys.count(key) > 0;
+}
+} // end namespace itk
@@ -0,0 +1,408 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOFormatRegistry.h"
+#include "itkSCIFIOMetaDataCache.h"
+#include "itksys/Directory.hxx"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#ifdef _WIN32
+#  include <process.h>
+#  define getpid _getpid
+#else
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+namespace
+{
+// bump whenever the meaning of the saved formats changes
+const char * const registryFormat = "SCIFIOFormatRegistry 1";
+const char * const registryFileName = "scifio-formats.cache";
+
+// probing the same files over and over is the common case; this only
+// bounds the memory of long running processes
+const size_t maximumNumberOfResults = 4096;
+
+struct Signature
+{
+  uint64_t    Offset;
+  std::string Bytes;
+};
+
+/*
+ * Shared state of the registry.
+ */
+class RegistryState
+{
+public:
+  std::mutex                  m_Mutex;
+  bool                        m_Loaded{ false };
+  std::set<std::string>       m_ReadSuffixes;
+  std::set<std::string>       m_WriteSuffixes;
+  std::vector<Signature>      m_Signatures;
+  std::map<std::string, bool> m_Results;
+};
+
+RegistryState &
+GetRegistryState()
+{
+  static RegistryState state;
+  return state;
+}
+
+// Identifies the installed JAR files, so that upgrading them invalidates
+// the saved formats
+std::string
+MakeJarSignature(const std::string & jarDirectory)
+{
+  itksys::Directory dir;
+  if (!dir.Load(jarDirectory))
+  {
+    return "";
+  }
+  std::vector<std::string> jars;
+  for (unsigned long i = 0; i < dir.GetNumberOfFiles(); ++i)
+  {
+    const std::string name = dir.GetFile(i);
+    if (name.size() > 4 && itksys::SystemTools::LowerCase(name.substr(name.size() - 4)) == ".jar")
+    {
+      jars.push_back(name);
+    }
+  }
+  std::sort(jars.begin(), jars.end());
+
+  std::ostringstream signature;
+  for (const auto & jar : jars)
+  {
+    const std::string path = jarDirectory + "/" + jar;
+    signature << jar << '\n'
+              << itksys::SystemTools::FileLength(path) << '\n'
+              << itksys::SystemTools::ModifiedTime(path) << '\n';
+  }
+  return signature.str();
+}
+
+// The file stamp of the metadata cache, so that a file rewritten in place
+// is asked about again; absent files (such as SCIFIO's synthetic .fake
+// files) are keyed by name alone
+std::string
+MakeResultKey(const std::string & fileName)
+{
+  const std::string stamp = SCIFIOMetaDataCache::GetFileStamp(fileName);
+  if (stamp.empty())
+  {
+    return fileName;
+  }
+  return itksys::SystemTools::CollapseFullPath(fileName) + '\n' + stamp;
+}
+
+// Every candidate suffix of the file name, so that both "tif" and
+// "ome.tif" are tried for "image.ome.tif"
+std::vector<std::string>
+GetSuffixes(const std::string & fileName)
+{
+  const std::string        name = itksys::SystemTools::LowerCase(itksys::SystemTools::GetFilenameName(fileName));
+  std::vector<std::string> suffixes;
+  for (size_t dot = name.find('.'); dot != std::string::npos; dot = name.find('.', dot + 1))
+  {
+    suffixes.push_back(name.substr(dot + 1));
+  }
+  return suffixes;
+}
+
+bool
+HasSuffix(const std::set<std::string> & supported, const std::string & fileName)
+{
+  for (const auto & suffix : GetSuffixes(fileName))
+  {
+    if (supported.count(suffix) > 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+DecodeHex(const std::string & hex, std::string & bytes)
+{
+  if (hex.empty() || hex.size() % 2 != 0)
+  {
+    return false;
+  }
+  bytes.clear();
+  for (size_t i = 0; i < hex.size(); i += 2)
+  {
+    unsigned int value;
+    if (!std::isxdigit(static_cast<unsigned char>(hex[i])) || !std::isxdigit(static_cast<unsigned char>(hex[i + 1])) ||
+        !(std::istringstream(hex.substr(i, 2)) >> std::hex >> value))
+    {
+      return false;
+    }
+    bytes += static_cast<char>(value);
+  }
+  return true;
+}
+
+// Must be called with the registry mutex held.
+void
+AddFormat(RegistryState & state, const std::string & kind, const std::string & value)
+{
+  if (kind == "read")
+  {
+    state.m_ReadSuffixes.insert(itksys::SystemTools::LowerCase(value));
+  }
+  else if (kind == "write")
+  {
+    state.m_WriteSuffixes.insert(itksys::SystemTools::LowerCase(value));
+  }
+  else if (kind == "magic")
+  {
+    std::istringstream iss(value);
+    Signature          signature;
+    std::string        hex;
+    if (iss >> signature.Offset >> hex && DecodeHex(hex, signature.Bytes))
+    {
+      state.m_Signatures.push_back(signature);
+    }
+  }
+}
+
+void
+WriteString(std::ostream & out, const std::string & value)
+{
+  out << value.size() << '\n';
+  out.write(value.data(), value.size());
+}
+
+bool
+ReadString(std::istream & in, std::string & value)
+{
+  size_t length;
+  if (!(in >> length) || in.get() != '\n')
+  {
+    return false;
+  }
+  value.resize(length);
+  return length == 0 || static_cast<bool>(in.read(&value[0], length));
+}
+
+void
+WriteRegistry(const std::string & path, const std::string & jarSignature, const SCIFIOBridgeFields & formats)
+{
+  // other processes may be loading the registry: write it aside, and move
+  // it in place once complete
+  const std::string temporary = path + "." + std::to_string(getpid()) + ".tmp";
+  {
+    std::ofstream out(temporary.c_str(), std::ios::binary);
+    out << registryFormat << '\n';
+    WriteString(out, jarSignature);
+    out << formats.size() << '\n';
+    for (const auto & field : formats)
+    {
+      WriteString(out, field.ToString());
+    }
+    if (!out)
+    {
+      out.close();
+      itksys::SystemTools::RemoveFile(temporary);
+      return;
+    }
+  }
+  if (!itksys::SystemTools::RenameFile(temporary, path))
+  {
+    itksys::SystemTools::RemoveFile(temporary);
+  }
+}
+} // namespace
+
+
+bool
+SCIFIOFormatRegistry::Load(const std::string & jarDirectory)
+{
+  const std::string path = jarDirectory + "/" + registryFileName;
+  std::ifstream     in(path.c_str(), std::ios::binary);
+  std::string       format;
+  std::string       jarSignature;
+  if (!std::getline(in, format) || format != registryFormat || !ReadString(in, jarSignature) ||
+      jarSignature != MakeJarSignature(jarDirectory))
+  {
+    // missing, unreadable, or saved for other JAR files
+    return false;
+  }
+  size_t count;
+  if (!(in >> count) || in.get() != '\n')
+  {
+    return false;
+  }
+  SCIFIOBridgeFields formats;
+  formats.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    std::string value;
+    if (!ReadString(in, value))
+    {
+      return false;
+    }
+    formats.emplace_back(value);
+  }
+
+  RegistryState &             state = GetRegistryState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  for (size_t i = 0; i + 1 < formats.size(); i += 2)
+  {
+    AddFormat(state, formats[i].ToString(), formats[i + 1].ToString());
+  }
+  state.m_Loaded = true;
+  return true;
+}
+
+
+void
+SCIFIOFormatRegistry::Register(const std::string & jarDirectory, const SCIFIOBridgeFields & formats)
+{
+  {
+    RegistryState &             state = GetRegistryState();
+    std::lock_guard<std::mutex> lock(state.m_Mutex);
+    for (size_t i = 0; i + 1 < formats.size(); i += 2)
+    {
+      AddFormat(state, formats[i].ToString(), formats[i + 1].ToString());
+    }
+    state.m_Loaded = true;
+  }
+
+  const std::string jarSignature = MakeJarSignature(jarDirectory);
+  if (!jarSignature.empty())
+  {
+    WriteRegistry(jarDirectory + "/" + registryFileName, jarSignature, formats);
+  }
+}
+
+
+bool
+SCIFIOFormatRegistry::IsLoaded()
+{
+  RegistryState &             state = GetRegistryState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  return state.m_Loaded;
+}
+
+
+bool
+SCIFIOFormatRegistry::MightRead(const std::string & fileName)
+{
+  RegistryState &        state = GetRegistryState();
+  std::vector<Signature> signatures;
+  {
+    std::lock_guard<std::mutex> lock(state.m_Mutex);
+    if (!state.m_Loaded || HasSuffix(state.m_ReadSuffixes, fileName))
+    {
+      return true;
+    }
+    signatures = state.m_Signatures;
+  }
+
+  // look at the start of the file only once, for all signatures
+  uint64_t headerLength = 0;
+  for (const auto & signature : signatures)
+  {
+    headerLength = std::max<uint64_t>(headerLength, signature.Offset + signature.Bytes.size());
+  }
+  if (headerLength == 0 || itksys::SystemTools::FileIsDirectory(fileName))
+  {
+    return false;
+  }
+  std::ifstream in(fileName.c_str(), std::ios::binary);
+  std::string   header(static_cast<size_t>(headerLength), '\0');
+  in.read(&header[0], static_cast<std::streamsize>(headerLength));
+  header.resize(static_cast<size_t>(in.gcount()));
+
+  for (const auto & signature : signatures)
+  {
+    if (signature.Offset + signature.Bytes.size() <= header.size() &&
+        header.compare(static_cast<size_t>(signature.Offset), signature.Bytes.size(), signature.Bytes) == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+bool
+SCIFIOFormatRegistry::MightWrite(const std::string & fileName)
+{
+  RegistryState &             state = GetRegistryState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  return !state.m_Loaded || HasSuffix(state.m_WriteSuffixes, fileName);
+}
+
+
+bool
+SCIFIOFormatRegistry::FindCanRead(const std::string & fileName, bool & canRead)
+{
+  const std::string           key = MakeResultKey(fileName);
+  RegistryState &             state = GetRegistryState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  const auto                  found = state.m_Results.find(key);
+  if (found == state.m_Results.end())
+  {
+    return false;
+  }
+  canRead = found->second;
+  return true;
+}
+
+
+void
+SCIFIOFormatRegistry::StoreCanRead(const std::string & fileName, bool canRead)
+{
+  const std::string           key = MakeResultKey(fileName);
+  RegistryState &             state = GetRegistryState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  if (state.m_Results.size() >= maximumNumberOfResults)
+  {
+    state.m_Results.clear();
+  }
+  state.m_Results[key] = canRead;
+}
+
+
+void
+SCIFIOFormatRegistry::Clear()
+{
+  RegistryState &             state = GetRegistryState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  state.m_Loaded = false;
+  state.m_ReadSuffixes.clear();
+  state.m_WriteSuffixes.clear();
+  state.m_Signatures.clear();
+  state.m_Results.clear();
+}
+} // end namespace itk
@@ -0,0 +1,159 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageRegionSplitter.h"
+
+#include <algorithm>
+
+namespace itk
+{
+namespace
+{
+// Index of the tile holding the pixel at index, also for negative indices
+IndexValueType
+tileOf(IndexValueType index, SizeValueType tileSize)
+{
+  const auto size = static_cast<IndexValueType>(tileSize);
+  return index >= 0 ? index / size : -((-index + size - 1) / size);
+}
+} // namespace
+
+
+unsigned int
+SCIFIOImageRegionSplitter::GetNumberOfSplits(const ImageIORegion & region, unsigned int requestedNumber) const
+{
+  return this->GetNumberOfSplitsInternal(
+    region.GetImageDimension(), region.GetIndex().data(), region.GetSize().data(), requestedNumber);
+}
+
+
+unsigned int
+SCIFIOImageRegionSplitter::GetSplit(unsigned int i, unsigned int numberOfPieces, ImageIORegion & region) const
+{
+  ImageIORegion::IndexType index = region.GetIndex();
+  ImageIORegion::SizeType  size = region.GetSize();
+  const unsigned int       numberOfSplits =
+    this->GetSplitInternal(region.GetImageDimension(), i, numberOfPieces, index.data(), size.data());
+  region.SetIndex(index);
+  region.SetSize(size);
+  return numberOfSplits;
+}
+
+
+SizeValueType
+SCIFIOImageRegionSplitter::GetTileSize(unsigned int axis) const
+{
+  SizeValueType tileSize = 1;
+  if (axis == 0)
+  {
+    tileSize = m_TileWidth;
+  }
+  else if (axis == 1)
+  {
+    tileSize = m_TileHeight;
+  }
+  return std::max<SizeValueType>(tileSize, 1);
+}
+
+
+// The slowest axis the region spans more than one tile of; beyond X and Y
+// every pixel is a tile of its own
+bool
+SCIFIOImageRegionSplitter::FindSplitAxis(unsigned int         dim,
+                                         const IndexValueType regionIndex[],
+                                         const SizeValueType  regionSize[],
+                                         unsigned int &       axis,
+                                         SizeValueType &      numberOfTiles) const
+{
+  for (int d = static_cast<int>(dim) - 1; d >= 0; --d)
+  {
+    if (regionSize[d] == 0)
+    {
+      continue;
+    }
+    const SizeValueType  tileSize = this->GetTileSize(d);
+    const IndexValueType last = regionIndex[d] + static_cast<IndexValueType>(regionSize[d]) - 1;
+    numberOfTiles = static_cast<SizeValueType>(tileOf(last, tileSize) - tileOf(regionIndex[d], tileSize) + 1);
+    if (numberOfTiles > 1)
+    {
+      axis = d;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+unsigned int
+SCIFIOImageRegionSplitter::GetNumberOfSplitsInternal(unsigned int         dim,
+                                                     const IndexValueType regionIndex[],
+                                                     const SizeValueType  regionSize[],
+                                                     unsigned int         requestedNumber) const
+{
+  unsigned int  axis;
+  SizeValueType numberOfTiles;
+  if (requestedNumber <= 1 || !this->FindSplitAxis(dim, regionIndex, regionSize, axis, numberOfTiles))
+  {
+    return 1;
+  }
+  const SizeValueType tilesPerPiece = (numberOfTiles + requestedNumber - 1) / requestedNumber;
+  return static_cast<unsigned int>((numberOfTiles + tilesPerPiece - 1) / tilesPerPiece);
+}
+
+
+unsigned int
+SCIFIOImageRegionSplitter::GetSplitInternal(unsigned int   dim,
+                                            unsigned int   i,
+                                            unsigned int   numberOfPieces,
+                                            IndexValueType regionIndex[],
+                                            SizeValueType  regionSize[]) const
+{
+  unsigned int  axis;
+  SizeValueType numberOfTiles;
+  if (numberOfPieces <= 1 || !this->FindSplitAxis(dim, regionIndex, regionSize, axis, numberOfTiles))
+  {
+    return 1;
+  }
+  const SizeValueType tilesPerPiece = (numberOfTiles + numberOfPieces - 1) / numberOfPieces;
+  const auto          numberOfSplits = static_cast<unsigned int>((numberOfTiles + tilesPerPiece - 1) / tilesPerPiece);
+  if (i >= numberOfSplits)
+  {
+    itkExceptionMacro(<< "SCIFIOImageRegionSplitter: piece " << i << " of " << numberOfSplits << " requested");
+  }
+
+  // the piece covers its tiles, clipped to the region
+  const auto           tile = static_cast<IndexValueType>(this->GetTileSize(axis));
+  const IndexValueType firstTile = tileOf(regionIndex[axis], this->GetTileSize(axis)) +
+                                   static_cast<IndexValueType>(i * tilesPerPiece);
+  const IndexValueType regionEnd = regionIndex[axis] + static_cast<IndexValueType>(regionSize[axis]);
+  const IndexValueType begin = std::max(regionIndex[axis], firstTile * tile);
+  const IndexValueType end =
+    std::min(regionEnd, (firstTile + static_cast<IndexValueType>(tilesPerPiece)) * tile);
+  regionIndex[axis] = begin;
+  regionSize[axis] = static_cast<SizeValueType>(end - begin);
+  return numberOfSplits;
+}
+
+
+void
+SCIFIOImageRegionSplitter::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "TileWidth: " << m_TileWidth << std::endl;
+  os << indent << "TileHeight: " << m_TileHeight << std::endl;
+}
+} // end namespace itk
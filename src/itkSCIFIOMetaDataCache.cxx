@@ -0,0 +1,452 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOMetaDataCache.h"
+#include "itksys/Directory.hxx"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <list>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#  include <process.h>
+#  define getpid _getpid
+#else
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+namespace
+{
+// bump whenever the meaning of the cached values changes
+const char * const cacheFormat = "SCIFIOMetaDataCache 3";
+const char * const cacheSuffix = ".scifio-metadata";
+
+std::string
+getEnv(const char * name)
+{
+  const char * result = itksys::SystemTools::GetEnv(name);
+  if (result == nullptr)
+  {
+    return "";
+  }
+  return result;
+}
+
+// Identify the file by its canonical path and stamp, so that entries of a
+// modified file are simply never found again.
+std::string
+MakeKey(const std::string & fileName, int series, int resolution, const std::string & selection)
+{
+  const std::string stamp = SCIFIOMetaDataCache::GetFileStamp(fileName);
+  if (stamp.empty())
+  {
+    return "";
+  }
+  std::ostringstream key;
+  key << itksys::SystemTools::CollapseFullPath(fileName) << '\n'
+      << stamp << '\n'
+      << series << '\n'
+      << resolution;
+  if (!selection.empty())
+  {
+    // the keys of complete entries are the same as before selections
+    key << '\n' << selection;
+  }
+  return key.str();
+}
+
+// FNV-1a, stable across runs and platforms, unlike std::hash
+std::string
+MakeFileName(const std::string & key)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char c : key)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream name;
+  name << std::hex << hash << cacheSuffix;
+  return name.str();
+}
+
+void
+WriteString(std::ostream & out, const std::string & value)
+{
+  out << value.size() << '\n';
+  out.write(value.data(), value.size());
+}
+
+bool
+ReadString(std::istream & in, std::string & value)
+{
+  size_t length;
+  if (!(in >> length) || in.get() != '\n')
+  {
+    return false;
+  }
+  value.resize(length);
+  return length == 0 || static_cast<bool>(in.read(&value[0], length));
+}
+
+bool
+ReadEntry(const std::string & path, const std::string & key, SCIFIOMetaDataCache::EntryType & entry)
+{
+  std::ifstream in(path.c_str(), std::ios::binary);
+  std::string   format;
+  std::string   storedKey;
+  if (!std::getline(in, format) || format != cacheFormat || !ReadString(in, storedKey) || storedKey != key)
+  {
+    // unreadable, outdated, or a hash collision
+    return false;
+  }
+  size_t count;
+  if (!(in >> count) || in.get() != '\n')
+  {
+    return false;
+  }
+  SCIFIOMetaDataCache::EntryType result;
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    std::pair<std::string, std::string> pair;
+    if (!ReadString(in, pair.first) || !ReadString(in, pair.second))
+    {
+      return false;
+    }
+    result.push_back(std::move(pair));
+  }
+  entry.swap(result);
+  return true;
+}
+
+void
+WriteEntry(const std::string & path, const std::string & key, const SCIFIOMetaDataCache::EntryType & entry)
+{
+  // other processes may be reading the same entry: write it aside, and
+  // move it in place once complete
+  const std::string temporary = path + "." + std::to_string(getpid()) + ".tmp";
+  {
+    std::ofstream out(temporary.c_str(), std::ios::binary);
+    out << cacheFormat << '\n';
+    WriteString(out, key);
+    out << entry.size() << '\n';
+    for (const auto & pair : entry)
+    {
+      WriteString(out, pair.first);
+      WriteString(out, pair.second);
+    }
+    if (!out)
+    {
+      out.close();
+      itksys::SystemTools::RemoveFile(temporary);
+      return;
+    }
+  }
+  if (!itksys::SystemTools::RenameFile(temporary, path))
+  {
+    itksys::SystemTools::RemoveFile(temporary);
+  }
+}
+
+// Remove the least recently used entries until the directory fits in the
+// given number of bytes.
+void
+TrimDirectory(const std::string & directory, unsigned long long maximumSize)
+{
+  itksys::Directory dir;
+  if (!dir.Load(directory))
+  {
+    return;
+  }
+
+  struct CachedFile
+  {
+    std::string        Path;
+    long int           Time;
+    unsigned long long Size;
+  };
+  std::vector<CachedFile> files;
+  unsigned long long      totalSize = 0;
+  const std::string       suffix(cacheSuffix);
+  for (unsigned long i = 0; i < dir.GetNumberOfFiles(); ++i)
+  {
+    const std::string name = dir.GetFile(i);
+    if (name.size() <= suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+    {
+      continue;
+    }
+    CachedFile file;
+    file.Path = directory + "/" + name;
+    file.Time = itksys::SystemTools::ModifiedTime(file.Path);
+    file.Size = itksys::SystemTools::FileLength(file.Path);
+    totalSize += file.Size;
+    files.push_back(file);
+  }
+  if (totalSize <= maximumSize)
+  {
+    return;
+  }
+
+  std::sort(files.begin(), files.end(), [](const CachedFile & a, const CachedFile & b) { return a.Time < b.Time; });
+  for (const auto & file : files)
+  {
+    if (totalSize <= maximumSize)
+    {
+      break;
+    }
+    itksys::SystemTools::RemoveFile(file.Path);
+    totalSize -= file.Size;
+  }
+}
+
+/*
+ * Shared state of the cache. The in-memory tier is a list in most
+ * recently used order, indexed by key.
+ */
+class CacheState
+{
+public:
+  using ListType = std::list<std::pair<std::string, SCIFIOMetaDataCache::EntryType>>;
+
+  CacheState()
+    : m_Directory(getEnv("SCIFIO_METADATA_CACHE_DIR"))
+  {
+    const std::string size = getEnv("SCIFIO_METADATA_CACHE_SIZE");
+    if (!size.empty())
+    {
+      m_MaximumDiskSize = static_cast<unsigned long long>(std::atof(size.c_str()) * 1024 * 1024);
+    }
+  }
+
+  std::mutex                                m_Mutex;
+  ListType                                  m_Entries;
+  std::map<std::string, ListType::iterator> m_Index;
+  unsigned int                              m_MaximumNumberOfEntries{ 256 };
+  std::string                               m_Directory;
+  unsigned long long                        m_MaximumDiskSize{ 64ULL * 1024 * 1024 };
+};
+
+CacheState &
+GetCacheState()
+{
+  static CacheState state;
+  return state;
+}
+
+// Must be called with the cache mutex held.
+void
+StoreInMemory(CacheState & state, const std::string & key, const SCIFIOMetaDataCache::EntryType & entry)
+{
+  const auto found = state.m_Index.find(key);
+  if (found != state.m_Index.end())
+  {
+    state.m_Entries.erase(found->second);
+    state.m_Index.erase(found);
+  }
+  if (state.m_MaximumNumberOfEntries == 0)
+  {
+    return;
+  }
+  state.m_Entries.emplace_front(key, entry);
+  state.m_Index[key] = state.m_Entries.begin();
+  while (state.m_Entries.size() > state.m_MaximumNumberOfEntries)
+  {
+    state.m_Index.erase(state.m_Entries.back().first);
+    state.m_Entries.pop_back();
+  }
+}
+} // namespace
+
+
+std::string
+SCIFIOMetaDataCache::GetFileStamp(const std::string & fileName)
+{
+  itksys::SystemTools::Stat_t status;
+  if (itksys::SystemTools::Stat(fileName, &status) != 0 || (status.st_mode & S_IFMT) != S_IFREG)
+  {
+    return "";
+  }
+  std::ostringstream stamp;
+  stamp << status.st_size << '\n' << static_cast<long long>(status.st_mtime);
+  // ModifiedTime() only has whole seconds
+#if defined(__APPLE__)
+  stamp << '.' << status.st_mtimespec.tv_nsec;
+#elif !defined(_WIN32)
+  stamp << '.' << status.st_mtim.tv_nsec;
+#endif
+  // files replaced by another one, e.g. by renaming, get another inode;
+  // always zero on Windows
+  stamp << '\n' << status.st_ino;
+  return stamp.str();
+}
+
+
+bool
+SCIFIOMetaDataCache::Find(const std::string & fileName,
+                          int                 series,
+                          int                 resolution,
+                          EntryType &         entry,
+                          const std::string & selection)
+{
+  const std::string key = MakeKey(fileName, series, resolution, selection);
+  if (key.empty())
+  {
+    return false;
+  }
+
+  CacheState & state = GetCacheState();
+  std::string  directory;
+  {
+    std::lock_guard<std::mutex> lock(state.m_Mutex);
+    const auto                  found = state.m_Index.find(key);
+    if (found != state.m_Index.end())
+    {
+      state.m_Entries.splice(state.m_Entries.begin(), state.m_Entries, found->second);
+      entry = found->second->second;
+      return true;
+    }
+    directory = state.m_Directory;
+  }
+
+  if (directory.empty())
+  {
+    return false;
+  }
+  const std::string path = directory + "/" + MakeFileName(key);
+  if (!itksys::SystemTools::FileExists(path, true) || !ReadEntry(path, key, entry))
+  {
+    return false;
+  }
+  // keep the file from being trimmed away while it is in use
+  itksys::SystemTools::Touch(path, false);
+
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  StoreInMemory(state, key, entry);
+  return true;
+}
+
+
+void
+SCIFIOMetaDataCache::Store(const std::string & fileName,
+                           int                 series,
+                           int                 resolution,
+                           const EntryType &   entry,
+                           const std::string & selection)
+{
+  const std::string key = MakeKey(fileName, series, resolution, selection);
+  if (key.empty())
+  {
+    return;
+  }
+
+  CacheState &       state = GetCacheState();
+  std::string        directory;
+  unsigned long long maximumDiskSize;
+  {
+    std::lock_guard<std::mutex> lock(state.m_Mutex);
+    StoreInMemory(state, key, entry);
+    directory = state.m_Directory;
+    maximumDiskSize = state.m_MaximumDiskSize;
+  }
+
+  if (directory.empty() || !itksys::SystemTools::MakeDirectory(directory))
+  {
+    return;
+  }
+  WriteEntry(directory + "/" + MakeFileName(key), key, entry);
+  TrimDirectory(directory, maximumDiskSize);
+}
+
+
+void
+SCIFIOMetaDataCache::SetDirectory(const std::string & directory)
+{
+  CacheState &                state = GetCacheState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  state.m_Directory = directory;
+}
+
+
+std::string
+SCIFIOMetaDataCache::GetDirectory()
+{
+  CacheState &                state = GetCacheState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  return state.m_Directory;
+}
+
+
+void
+SCIFIOMetaDataCache::SetMaximumNumberOfEntries(unsigned int number)
+{
+  CacheState &                state = GetCacheState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  state.m_MaximumNumberOfEntries = number;
+  while (state.m_Entries.size() > number)
+  {
+    state.m_Index.erase(state.m_Entries.back().first);
+    state.m_Entries.pop_back();
+  }
+}
+
+
+unsigned int
+SCIFIOMetaDataCache::GetMaximumNumberOfEntries()
+{
+  CacheState &                state = GetCacheState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  return state.m_MaximumNumberOfEntries;
+}
+
+
+void
+SCIFIOMetaDataCache::SetMaximumDiskSize(unsigned long long size)
+{
+  CacheState &                state = GetCacheState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  state.m_MaximumDiskSize = size;
+}
+
+
+unsigned long long
+SCIFIOMetaDataCache::GetMaximumDiskSize()
+{
+  CacheState &                state = GetCacheState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  return state.m_MaximumDiskSize;
+}
+
+
+void
+SCIFIOMetaDataCache::Clear()
+{
+  CacheState &                state = GetCacheState();
+  std::lock_guard<std::mutex> lock(state.m_Mutex);
+  state.m_Entries.clear();
+  state.m_Index.clear();
+}
+} // end namespace itk
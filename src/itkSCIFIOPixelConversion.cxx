@@ -0,0 +1,480 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOPixelConversion.h"
+#include "itkSCIFIOByteSwap.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define SCIFIO_PIXEL_CONVERSION_SSE2
+#  include <emmintrin.h>
+#  if defined(_MSC_VER)
+#    define SCIFIO_PIXEL_CONVERSION_SSSE3
+#    define SCIFIO_TARGET_SSSE3
+#    include <tmmintrin.h>
+#  elif defined(__GNUC__) || defined(__clang__)
+// compiled for SSSE3 whatever the flags, and only run on processors with
+// AVX2, which have it too
+#    define SCIFIO_PIXEL_CONVERSION_SSSE3
+#    define SCIFIO_TARGET_SSSE3 __attribute__((target("ssse3")))
+#    include <tmmintrin.h>
+#  endif
+#endif
+
+namespace itk
+{
+namespace
+{
+using IOComponentEnum = SCIFIOPixelConversion::IOComponentEnum;
+
+template <typename TDestination, typename TSource>
+void
+convert(TDestination * destination, const TSource * source, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    destination[i] = static_cast<TDestination>(source[i]);
+  }
+}
+
+#ifdef SCIFIO_PIXEL_CONVERSION_SSE2
+bool
+useSSE2()
+{
+  return SCIFIOByteSwap::GetInstructionSet() != SCIFIOByteSwap::InstructionSetEnum::SCALAR;
+}
+
+void
+convert(float * destination, const unsigned char * source, size_t count)
+{
+  size_t i = 0;
+  if (useSSE2())
+  {
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16)
+    {
+      const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+      const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+      const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+      _mm_storeu_ps(destination + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)));
+      _mm_storeu_ps(destination + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)));
+      _mm_storeu_ps(destination + i + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)));
+      _mm_storeu_ps(destination + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)));
+    }
+  }
+  convert<float, unsigned char>(destination + i, source + i, count - i);
+}
+
+void
+convert(float * destination, const unsigned short * source, size_t count)
+{
+  size_t i = 0;
+  if (useSSE2())
+  {
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+      _mm_storeu_ps(destination + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero)));
+      _mm_storeu_ps(destination + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(words, zero)));
+    }
+  }
+  convert<float, unsigned short>(destination + i, source + i, count - i);
+}
+
+void
+convert(float * destination, const short * source, size_t count)
+{
+  size_t i = 0;
+  if (useSSE2())
+  {
+    for (; i + 8 <= count; i += 8)
+    {
+      // each word in the upper half of a 32-bit lane, shifted back down
+      // with its sign
+      const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+      const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(words, words), 16);
+      const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(words, words), 16);
+      _mm_storeu_ps(destination + i, _mm_cvtepi32_ps(low));
+      _mm_storeu_ps(destination + i + 4, _mm_cvtepi32_ps(high));
+    }
+  }
+  convert<float, short>(destination + i, source + i, count - i);
+}
+
+void
+convert(double * destination, const float * source, size_t count)
+{
+  size_t i = 0;
+  if (useSSE2())
+  {
+    for (; i + 4 <= count; i += 4)
+    {
+      const __m128 values = _mm_loadu_ps(source + i);
+      _mm_storeu_pd(destination + i, _mm_cvtps_pd(values));
+      _mm_storeu_pd(destination + i + 2, _mm_cvtps_pd(_mm_movehl_ps(values, values)));
+    }
+  }
+  convert<double, float>(destination + i, source + i, count - i);
+}
+#endif
+
+template <typename TSource>
+void
+convertFrom(void * destination, IOComponentEnum destinationType, const TSource * source, size_t count)
+{
+  switch (destinationType)
+  {
+    case IOComponentEnum::CHAR:
+      convert(static_cast<char *>(destination), source, count);
+      break;
+    case IOComponentEnum::UCHAR:
+      convert(static_cast<unsigned char *>(destination), source, count);
+      break;
+    case IOComponentEnum::SHORT:
+      convert(static_cast<short *>(destination), source, count);
+      break;
+    case IOComponentEnum::USHORT:
+      convert(static_cast<unsigned short *>(destination), source, count);
+      break;
+    case IOComponentEnum::INT:
+      convert(static_cast<int *>(destination), source, count);
+      break;
+    case IOComponentEnum::UINT:
+      convert(static_cast<unsigned int *>(destination), source, count);
+      break;
+    case IOComponentEnum::LONG:
+      convert(static_cast<long *>(destination), source, count);
+      break;
+    case IOComponentEnum::ULONG:
+      convert(static_cast<unsigned long *>(destination), source, count);
+      break;
+    case IOComponentEnum::LONGLONG:
+      convert(static_cast<long long *>(destination), source, count);
+      break;
+    case IOComponentEnum::ULONGLONG:
+      convert(static_cast<unsigned long long *>(destination), source, count);
+      break;
+    case IOComponentEnum::FLOAT:
+      convert(static_cast<float *>(destination), source, count);
+      break;
+    case IOComponentEnum::DOUBLE:
+      convert(static_cast<double *>(destination), source, count);
+      break;
+    default:
+      break;
+  }
+}
+
+void
+convertAny(void * destination, IOComponentEnum destinationType, const void * source, IOComponentEnum sourceType, size_t count)
+{
+  switch (sourceType)
+  {
+    case IOComponentEnum::CHAR:
+      convertFrom(destination, destinationType, static_cast<const char *>(source), count);
+      break;
+    case IOComponentEnum::UCHAR:
+      convertFrom(destination, destinationType, static_cast<const unsigned char *>(source), count);
+      break;
+    case IOComponentEnum::SHORT:
+      convertFrom(destination, destinationType, static_cast<const short *>(source), count);
+      break;
+    case IOComponentEnum::USHORT:
+      convertFrom(destination, destinationType, static_cast<const unsigned short *>(source), count);
+      break;
+    case IOComponentEnum::INT:
+      convertFrom(destination, destinationType, static_cast<const int *>(source), count);
+      break;
+    case IOComponentEnum::UINT:
+      convertFrom(destination, destinationType, static_cast<const unsigned int *>(source), count);
+      break;
+    case IOComponentEnum::LONG:
+      convertFrom(destination, destinationType, static_cast<const long *>(source), count);
+      break;
+    case IOComponentEnum::ULONG:
+      convertFrom(destination, destinationType, static_cast<const unsigned long *>(source), count);
+      break;
+    case IOComponentEnum::LONGLONG:
+      convertFrom(destination, destinationType, static_cast<const long long *>(source), count);
+      break;
+    case IOComponentEnum::ULONGLONG:
+      convertFrom(destination, destinationType, static_cast<const unsigned long long *>(source), count);
+      break;
+    case IOComponentEnum::FLOAT:
+      convertFrom(destination, destinationType, static_cast<const float *>(source), count);
+      break;
+    case IOComponentEnum::DOUBLE:
+      convertFrom(destination, destinationType, static_cast<const double *>(source), count);
+      break;
+    default:
+      break;
+  }
+}
+
+// Interleave the pixels [begin, end) of channels stored channelStride
+// components apart, a block of pixels at a time so that the part of the
+// destination written for each channel stays in cache
+template <size_t VSize>
+void
+interleaveScalar(char *       destination,
+                 const char * source,
+                 unsigned int numberOfChannels,
+                 size_t       begin,
+                 size_t       end,
+                 size_t       channelStride)
+{
+  constexpr size_t blockPixels = 1024;
+  for (size_t block = begin; block < end; block += blockPixels)
+  {
+    const size_t blockEnd = std::min(block + blockPixels, end);
+    for (unsigned int c = 0; c < numberOfChannels; ++c)
+    {
+      const char * channel = source + c * channelStride * VSize;
+      for (size_t p = block; p < blockEnd; ++p)
+      {
+        memcpy(destination + (p * numberOfChannels + c) * VSize, channel + p * VSize, VSize);
+      }
+    }
+  }
+}
+
+#ifdef SCIFIO_PIXEL_CONVERSION_SSSE3
+bool
+useSSSE3()
+{
+  return SCIFIOByteSwap::GetInstructionSet() == SCIFIOByteSwap::InstructionSetEnum::AVX2;
+}
+
+// Interleave 16 bytes of each channel at a time into VChannels vectors:
+// each output vector gathers the bytes that land in it from every channel
+// with a byte shuffle. Returns the number of pixels done.
+template <unsigned int VChannels>
+SCIFIO_TARGET_SSSE3 size_t
+interleaveSSSE3(char * destination, const char * source, size_t componentSize, size_t numberOfPixels, size_t channelStride)
+{
+  alignas(16) char order[VChannels][VChannels][16];
+  for (unsigned int k = 0; k < VChannels; ++k)
+  {
+    for (unsigned int o = 0; o < 16; ++o)
+    {
+      const size_t       byte = 16 * k + o;
+      const size_t       pixel = byte / (VChannels * componentSize);
+      const unsigned int channel = (byte / componentSize) % VChannels;
+      for (unsigned int c = 0; c < VChannels; ++c)
+      {
+        order[k][c][o] =
+          c == channel ? static_cast<char>(pixel * componentSize + byte % componentSize) : static_cast<char>(0x80);
+      }
+    }
+  }
+  __m128i masks[VChannels][VChannels];
+  for (unsigned int k = 0; k < VChannels; ++k)
+  {
+    for (unsigned int c = 0; c < VChannels; ++c)
+    {
+      masks[k][c] = _mm_load_si128(reinterpret_cast<const __m128i *>(order[k][c]));
+    }
+  }
+
+  const size_t perVector = 16 / componentSize;
+  size_t       p = 0;
+  for (; p + perVector <= numberOfPixels; p += perVector)
+  {
+    __m128i channels[VChannels];
+    for (unsigned int c = 0; c < VChannels; ++c)
+    {
+      channels[c] = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(source + (c * channelStride + p) * componentSize));
+    }
+    char * out = destination + p * VChannels * componentSize;
+    for (unsigned int k = 0; k < VChannels; ++k)
+    {
+      __m128i value = _mm_shuffle_epi8(channels[0], masks[k][0]);
+      for (unsigned int c = 1; c < VChannels; ++c)
+      {
+        value = _mm_or_si128(value, _mm_shuffle_epi8(channels[c], masks[k][c]));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * k), value);
+    }
+  }
+  return p;
+}
+#endif
+
+void
+interleave(char *       destination,
+           const char * source,
+           size_t       componentSize,
+           unsigned int numberOfChannels,
+           size_t       numberOfPixels,
+           size_t       channelStride)
+{
+  size_t done = 0;
+#ifdef SCIFIO_PIXEL_CONVERSION_SSSE3
+  if (useSSSE3() && componentSize <= 8)
+  {
+    switch (numberOfChannels)
+    {
+      case 2:
+        done = interleaveSSSE3<2>(destination, source, componentSize, numberOfPixels, channelStride);
+        break;
+      case 3:
+        done = interleaveSSSE3<3>(destination, source, componentSize, numberOfPixels, channelStride);
+        break;
+      case 4:
+        done = interleaveSSSE3<4>(destination, source, componentSize, numberOfPixels, channelStride);
+        break;
+      default:
+        break;
+    }
+  }
+#endif
+  switch (componentSize)
+  {
+    case 1:
+      interleaveScalar<1>(destination, source, numberOfChannels, done, numberOfPixels, channelStride);
+      break;
+    case 2:
+      interleaveScalar<2>(destination, source, numberOfChannels, done, numberOfPixels, channelStride);
+      break;
+    case 4:
+      interleaveScalar<4>(destination, source, numberOfChannels, done, numberOfPixels, channelStride);
+      break;
+    case 8:
+      interleaveScalar<8>(destination, source, numberOfChannels, done, numberOfPixels, channelStride);
+      break;
+    default:
+      break;
+  }
+}
+} // namespace
+
+
+bool
+SCIFIOPixelConversion::IsSupported(IOComponentEnum sourceType, IOComponentEnum destinationType)
+{
+  return GetComponentTypeSize(sourceType) > 0 && GetComponentTypeSize(destinationType) > 0;
+}
+
+
+size_t
+SCIFIOPixelConversion::GetComponentTypeSize(IOComponentEnum componentType)
+{
+  switch (componentType)
+  {
+    case IOComponentEnum::CHAR:
+    case IOComponentEnum::UCHAR:
+      return 1;
+    case IOComponentEnum::SHORT:
+    case IOComponentEnum::USHORT:
+      return 2;
+    case IOComponentEnum::INT:
+    case IOComponentEnum::UINT:
+    case IOComponentEnum::FLOAT:
+      return 4;
+    case IOComponentEnum::LONG:
+    case IOComponentEnum::ULONG:
+      return sizeof(long);
+    case IOComponentEnum::LONGLONG:
+    case IOComponentEnum::ULONGLONG:
+    case IOComponentEnum::DOUBLE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+
+void
+SCIFIOPixelConversion::Convert(void *          destination,
+                               IOComponentEnum destinationType,
+                               const void *    source,
+                               IOComponentEnum sourceType,
+                               size_t          count,
+                               bool            swapSource)
+{
+  const size_t sourceSize = GetComponentTypeSize(sourceType);
+  if (!swapSource || sourceSize <= 1)
+  {
+    convertAny(destination, destinationType, source, sourceType, count);
+    return;
+  }
+
+  // swap a cache-sized piece at a time, then convert it from there
+  alignas(16) char swapped[16384];
+  const size_t     perPiece = sizeof(swapped) / sourceSize;
+  const size_t     destinationSize = GetComponentTypeSize(destinationType);
+  for (size_t i = 0; i < count; i += perPiece)
+  {
+    const size_t length = std::min(perPiece, count - i);
+    SCIFIOByteSwap::CopySwapRange(swapped, static_cast<const char *>(source) + i * sourceSize, sourceSize, length);
+    convertAny(static_cast<char *>(destination) + i * destinationSize, destinationType, swapped, sourceType, length);
+  }
+}
+
+
+void
+SCIFIOPixelConversion::ConvertPlanar(void *          destination,
+                                     IOComponentEnum destinationType,
+                                     const void *    source,
+                                     IOComponentEnum sourceType,
+                                     unsigned int    numberOfChannels,
+                                     size_t          numberOfPixels,
+                                     bool            swapSource)
+{
+  const size_t sourceSize = GetComponentTypeSize(sourceType);
+  const size_t destinationSize = GetComponentTypeSize(destinationType);
+  if (sourceType == destinationType && (!swapSource || sourceSize <= 1))
+  {
+    interleave(static_cast<char *>(destination),
+               static_cast<const char *>(source),
+               destinationSize,
+               numberOfChannels,
+               numberOfPixels,
+               numberOfPixels);
+    return;
+  }
+
+  // convert a block of pixels of every channel, and interleave the block
+  // while it is still in cache
+  const size_t      blockPixels = std::max<size_t>(16, 16384 / (numberOfChannels * destinationSize));
+  std::vector<char> block(blockPixels * numberOfChannels * destinationSize);
+  for (size_t p = 0; p < numberOfPixels; p += blockPixels)
+  {
+    const size_t length = std::min(blockPixels, numberOfPixels - p);
+    for (unsigned int c = 0; c < numberOfChannels; ++c)
+    {
+      Convert(&block[c * length * destinationSize],
+              destinationType,
+              static_cast<const char *>(source) + (c * numberOfPixels + p) * sourceSize,
+              sourceType,
+              length,
+              swapSource);
+    }
+    interleave(static_cast<char *>(destination) + p * numberOfChannels * destinationSize,
+               block.data(),
+               destinationSize,
+               numberOfChannels,
+               length,
+               length);
+  }
+}
+} // end namespace itk
@@ -0,0 +1,111 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOSharedMemory.h"
+#include "itkMacro.h"
+#include "itksys/SystemTools.hxx"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+namespace
+{
+const char * const sharedMemoryDirectory = "/dev/shm";
+}
+
+bool
+SCIFIOSharedMemory::IsSupported()
+{
+#ifdef _WIN32
+  return false;
+#else
+  return itksys::SystemTools::FileIsDirectory(sharedMemoryDirectory);
+#endif
+}
+
+
+SCIFIOSharedMemory::SCIFIOSharedMemory(size_t size)
+{
+#ifdef _WIN32
+  (void)size;
+  itkGenericExceptionMacro(<< "SCIFIOSharedMemory: shared memory transport is not supported on Windows");
+#else
+  if (!IsSupported())
+  {
+    itkGenericExceptionMacro(<< "SCIFIOSharedMemory: " << sharedMemoryDirectory << " is not available");
+  }
+
+  // mmap refuses empty mappings
+  m_Size = size > 0 ? size : 1;
+
+  static std::atomic<unsigned long> counter(0);
+  m_Path = std::string(sharedMemoryDirectory) + "/scifio-itk-" + std::to_string(getpid()) + "-" +
+           std::to_string(counter++);
+
+  const int fd = open(m_Path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0)
+  {
+    itkGenericExceptionMacro(<< "SCIFIOSharedMemory: cannot create " << m_Path << ": " << std::strerror(errno));
+  }
+  // ftruncate alone leaves a sparse file: if the file system is too small
+  // for it, the first write to a missing page raises SIGBUS rather than
+  // failing here, where the caller can still fall back to the pipe
+#  ifdef __APPLE__
+  const int error = ftruncate(fd, static_cast<off_t>(m_Size)) != 0 ? errno : 0;
+#  else
+  const int error = posix_fallocate(fd, 0, static_cast<off_t>(m_Size));
+#  endif
+  if (error != 0)
+  {
+    close(fd);
+    unlink(m_Path.c_str());
+    itkGenericExceptionMacro(<< "SCIFIOSharedMemory: cannot reserve " << m_Size << " bytes for " << m_Path << ": "
+                             << std::strerror(error));
+  }
+  void *    buffer = mmap(nullptr, m_Size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  const int mapError = errno;
+  close(fd);
+  if (buffer == MAP_FAILED)
+  {
+    unlink(m_Path.c_str());
+    itkGenericExceptionMacro(<< "SCIFIOSharedMemory: cannot map " << m_Path << ": " << std::strerror(mapError));
+  }
+  m_Buffer = buffer;
+#endif
+}
+
+
+SCIFIOSharedMemory::~SCIFIOSharedMemory()
+{
+#ifndef _WIN32
+  if (m_Buffer != nullptr)
+  {
+    munmap(m_Buffer, m_Size);
+    unlink(m_Path.c_str());
+  }
+#endif
+}
+} // end namespace itk
@@ -0,0 +1,96 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOTileCache.h"
+
+#include <tuple>
+
+namespace itk
+{
+bool
+SCIFIOTileCache::KeyType::operator<(const KeyType & other) const
+{
+  return std::tie(FileName, FileStamp, Series, Resolution, Index) <
+         std::tie(other.FileName, other.FileStamp, other.Series, other.Resolution, other.Index);
+}
+
+
+const SCIFIOTileCache::BufferType *
+SCIFIOTileCache::Find(const KeyType & key)
+{
+  const auto found = m_Index.find(key);
+  if (found == m_Index.end())
+  {
+    ++m_NumberOfMisses;
+    return nullptr;
+  }
+  ++m_NumberOfHits;
+  // most recently used tiles are at the front
+  m_Tiles.splice(m_Tiles.begin(), m_Tiles, found->second);
+  return &found->second->second;
+}
+
+
+void
+SCIFIOTileCache::Insert(const KeyType & key, BufferType && tile)
+{
+  const auto found = m_Index.find(key);
+  if (found != m_Index.end())
+  {
+    m_Size -= found->second->second.size();
+    m_Tiles.erase(found->second);
+    m_Index.erase(found);
+  }
+  if (tile.size() > m_MaximumSize)
+  {
+    return;
+  }
+  Evict(m_MaximumSize - tile.size());
+  m_Size += tile.size();
+  m_Tiles.emplace_front(key, std::move(tile));
+  m_Index[key] = m_Tiles.begin();
+}
+
+
+void
+SCIFIOTileCache::SetMaximumSize(size_t size)
+{
+  m_MaximumSize = size;
+  Evict(size);
+}
+
+
+void
+SCIFIOTileCache::Clear()
+{
+  m_Tiles.clear();
+  m_Index.clear();
+  m_Size = 0;
+}
+
+
+void
+SCIFIOTileCache::Evict(size_t maximumSize)
+{
+  while (m_Size > maximumSize)
+  {
+    m_Size -= m_Tiles.back().second.size();
+    m_Index.erase(m_Tiles.back().first);
+    m_Tiles.pop_back();
+  }
+}
+} // end namespace itk
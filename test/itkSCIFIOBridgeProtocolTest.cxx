@@ -0,0 +1,223 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOBridgeProtocol.h"
+#include "itkMacro.h"
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace
+{
+using itk::SCIFIOBridgeField;
+using itk::SCIFIOBridgeFields;
+using itk::SCIFIOBridgeProtocol;
+
+bool
+SameField(const SCIFIOBridgeField & a, const SCIFIOBridgeField & b)
+{
+  if (a.GetType() != b.GetType())
+  {
+    return false;
+  }
+  switch (a.GetType())
+  {
+    case SCIFIOBridgeField::TypeEnum::String:
+      return a.ToString() == b.ToString();
+    case SCIFIOBridgeField::TypeEnum::Int64:
+      return a.ToInt64() == b.ToInt64();
+    case SCIFIOBridgeField::TypeEnum::Double:
+      return a.ToDouble() == b.ToDouble();
+    case SCIFIOBridgeField::TypeEnum::Bool:
+      return a.ToBool() == b.ToBool();
+  }
+  return false;
+}
+
+bool
+DecodeFails(const std::string & payload)
+{
+  try
+  {
+    SCIFIOBridgeProtocol::DecodeFields(payload.data(), payload.size());
+  }
+  catch (itk::ExceptionObject &)
+  {
+    return true;
+  }
+  return false;
+}
+
+bool
+DecodeHeaderFails(const std::string & header)
+{
+  try
+  {
+    SCIFIOBridgeProtocol::DecodeHeader(header.data());
+  }
+  catch (itk::ExceptionObject &)
+  {
+    return true;
+  }
+  return false;
+}
+} // namespace
+
+/*
+ * Encodes frames of all field types and decodes them again. Then checks
+ * that payloads cut in the middle of a field, string lengths beyond the
+ * end of the payload, unknown field types, and headers with a wrong magic
+ * or version are rejected rather than read past.
+ */
+int
+itkSCIFIOBridgeProtocolTest(int, char *[])
+{
+  const char               special[] = "tab\tnew line\n\\ and a \0 byte";
+  const SCIFIOBridgeFields fields{ "read",
+                                   std::string(special, sizeof(special) - 1),
+                                   "",
+                                   0,
+                                   -1,
+                                   std::numeric_limits<long long>::max(),
+                                   std::numeric_limits<long long>::min(),
+                                   0.25,
+                                   -1.0e300,
+                                   true,
+                                   false };
+  const uint32_t           requestId = 0xdeadbeef;
+
+  // round trip
+  const std::string frame =
+    SCIFIOBridgeProtocol::EncodeFrame(SCIFIOBridgeProtocol::MessageEnum::Command, requestId, fields);
+  if (frame.size() < SCIFIOBridgeProtocol::HeaderLength || frame.compare(0, 4, "SCIF") != 0)
+  {
+    std::cerr << "[ERROR] the frame does not start with the magic" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const SCIFIOBridgeProtocol::FrameHeader header = SCIFIOBridgeProtocol::DecodeHeader(frame.data());
+  if (header.Type != SCIFIOBridgeProtocol::MessageEnum::Command || header.RequestId != requestId ||
+      header.PayloadLength != frame.size() - SCIFIOBridgeProtocol::HeaderLength)
+  {
+    std::cerr << "[ERROR] wrong header: type " << static_cast<int>(header.Type) << ", request " << header.RequestId
+              << ", " << header.PayloadLength << " bytes of payload" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string        payload = frame.substr(SCIFIOBridgeProtocol::HeaderLength);
+  const SCIFIOBridgeFields decoded = SCIFIOBridgeProtocol::DecodeFields(payload.data(), payload.size());
+  if (decoded.size() != fields.size())
+  {
+    std::cerr << "[ERROR] decoded " << decoded.size() << " fields, expected " << fields.size() << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (size_t i = 0; i < fields.size(); ++i)
+  {
+    if (!SameField(decoded[i], fields[i]))
+    {
+      std::cerr << "[ERROR] field " << i << " decoded as " << decoded[i].ToString() << ", expected "
+                << fields[i].ToString() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // data frames announce payloads beyond 2^32 bytes
+  const uint64_t    largeLength = (uint64_t(1) << 40) + 3;
+  const std::string dataHeader =
+    SCIFIOBridgeProtocol::EncodeHeader(SCIFIOBridgeProtocol::MessageEnum::Data, requestId, largeLength);
+  const SCIFIOBridgeProtocol::FrameHeader data = SCIFIOBridgeProtocol::DecodeHeader(dataHeader.data());
+  if (dataHeader.size() != SCIFIOBridgeProtocol::HeaderLength ||
+      data.Type != SCIFIOBridgeProtocol::MessageEnum::Data || data.PayloadLength != largeLength)
+  {
+    std::cerr << "[ERROR] wrong data header: " << data.PayloadLength << " bytes of payload" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // a payload cut between two fields holds the fields before the cut, one
+  // cut within a field is rejected
+  size_t boundary = 0;
+  for (size_t count = 0; count <= fields.size(); ++count)
+  {
+    const SCIFIOBridgeFields first(fields.begin(), fields.begin() + count);
+    const size_t             next =
+      SCIFIOBridgeProtocol::EncodeFrame(SCIFIOBridgeProtocol::MessageEnum::Command, requestId, first).size() -
+      SCIFIOBridgeProtocol::HeaderLength;
+    for (size_t length = boundary + 1; length < next; ++length)
+    {
+      if (!DecodeFails(payload.substr(0, length)))
+      {
+        std::cerr << "[ERROR] accepted a payload cut after " << length << " bytes, within field " << count - 1
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    const SCIFIOBridgeFields cut = SCIFIOBridgeProtocol::DecodeFields(payload.data(), next);
+    if (cut.size() != count)
+    {
+      std::cerr << "[ERROR] decoded " << cut.size() << " fields of a payload cut after " << count << std::endl;
+      return EXIT_FAILURE;
+    }
+    boundary = next;
+  }
+
+  // string lengths beyond the end of the payload, up to the largest one
+  for (const uint32_t length : { uint32_t(6), uint32_t(0x7fffffff), uint32_t(0xffffffff) })
+  {
+    std::string oversized(1, static_cast<char>(SCIFIOBridgeField::TypeEnum::String));
+    for (unsigned int b = 0; b < 4; ++b)
+    {
+      oversized += static_cast<char>((length >> (8 * b)) & 0xff);
+    }
+    oversized += "abcde";
+    if (!DecodeFails(oversized))
+    {
+      std::cerr << "[ERROR] accepted a string of " << length << " bytes in a payload of " << oversized.size()
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // unknown field types
+  if (!DecodeFails(std::string(9, '\x07')))
+  {
+    std::cerr << "[ERROR] accepted an unknown field type" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // headers of other protocols, or of other versions of this one
+  std::string badMagic(frame, 0, SCIFIOBridgeProtocol::HeaderLength);
+  badMagic[0] = 'X';
+  std::string badVersion(frame, 0, SCIFIOBridgeProtocol::HeaderLength);
+  badVersion[4] = static_cast<char>(SCIFIOBridgeProtocol::Version + 1);
+  if (!DecodeHeaderFails(badMagic) || !DecodeHeaderFails(badVersion) ||
+      !DecodeHeaderFails(std::string(SCIFIOBridgeProtocol::HeaderLength, '\n')))
+  {
+    std::cerr << "[ERROR] accepted a header with a wrong magic or version" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // the text protocol, for comparison
+  const SCIFIOBridgeFields text = SCIFIOBridgeProtocol::DecodeTextReply("512\n0.5\ntrue\n\n");
+  if (SCIFIOBridgeProtocol::EncodeTextCommand({ "read", 1, 2.5 }) != "read\t1\t2.5\n" || text.size() != 3 ||
+      text[0].ToInt64() != 512 || text[1].ToDouble() != 0.5 || !text[2].ToBool())
+  {
+    std::cerr << "[ERROR] wrong text command or reply" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
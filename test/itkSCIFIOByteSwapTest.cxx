@@ -0,0 +1,131 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOByteSwap.h"
+#include "itkImageIOBase.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+using InstructionSetEnum = itk::SCIFIOByteSwap::InstructionSetEnum;
+
+// Swap the values of one of the component types the bridge can report with
+// the current instruction set, and check them against a byte by byte
+// reversal
+template <typename TComponent>
+bool
+CheckComponentType(itk::IOComponentEnum componentType)
+{
+  const std::string name = itk::ImageIOBase::GetComponentTypeAsString(componentType);
+
+  // lengths around the vector sizes, so that the scalar tails are covered,
+  // and unaligned starts
+  for (const size_t count : { 0, 1, 3, 15, 16, 17, 31, 32, 33, 1000 })
+  {
+    for (const size_t offset : { 0, 1, 3 })
+    {
+      // a spare byte at the end, so that empty ranges have an address too
+      std::vector<char> original(offset + count * sizeof(TComponent) + 1);
+      for (size_t i = 0; i < count; ++i)
+      {
+        const auto value = static_cast<TComponent>(i * 37 + 11);
+        memcpy(&original[offset + i * sizeof(TComponent)], &value, sizeof(TComponent));
+      }
+      std::vector<char> expected(original);
+      for (size_t i = 0; i < count; ++i)
+      {
+        for (size_t b = 0; b < sizeof(TComponent); ++b)
+        {
+          expected[offset + i * sizeof(TComponent) + b] = original[offset + (i + 1) * sizeof(TComponent) - 1 - b];
+        }
+      }
+
+      std::vector<char> copied(original.size());
+      itk::SCIFIOByteSwap::CopySwapRange(&copied[offset], &original[offset], sizeof(TComponent), count);
+      if (memcmp(&copied[offset], &expected[offset], count * sizeof(TComponent)) != 0)
+      {
+        std::cerr << "[ERROR] wrong copy of " << count << ' ' << name << " values at offset " << offset << std::endl;
+        return false;
+      }
+
+      std::vector<char> swapped(original);
+      itk::SCIFIOByteSwap::SwapRange(&swapped[offset], sizeof(TComponent), count);
+      if (swapped != expected)
+      {
+        std::cerr << "[ERROR] wrong swap of " << count << ' ' << name << " values at offset " << offset << std::endl;
+        return false;
+      }
+      itk::SCIFIOByteSwap::SwapRange(&swapped[offset], sizeof(TComponent), count);
+      if (swapped != original)
+      {
+        std::cerr << "[ERROR] swapping " << count << ' ' << name << " values twice changed them" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkSCIFIOByteSwapTest(int, char *[])
+{
+  std::cout << "System is " << (itk::SCIFIOByteSwap::IsSystemLittleEndian() ? "little" : "big") << " endian"
+            << std::endl;
+
+  const InstructionSetEnum best = itk::SCIFIOByteSwap::GetInstructionSet();
+  if (!itk::SCIFIOByteSwap::IsInstructionSetSupported(best))
+  {
+    std::cerr << "[ERROR] the default instruction set is not supported" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const char * names[] = { "scalar", "SSE2", "AVX2" };
+  for (const InstructionSetEnum instructionSet :
+       { InstructionSetEnum::SCALAR, InstructionSetEnum::SSE2, InstructionSetEnum::AVX2 })
+  {
+    const char * name = names[static_cast<int>(instructionSet)];
+    if (!itk::SCIFIOByteSwap::SetInstructionSet(instructionSet))
+    {
+      std::cout << name << ": not supported" << std::endl;
+      continue;
+    }
+    std::cout << name << std::endl;
+
+    // the component types of scifioToITKComponentType
+    if (!CheckComponentType<char>(itk::IOComponentEnum::CHAR) ||
+        !CheckComponentType<unsigned char>(itk::IOComponentEnum::UCHAR) ||
+        !CheckComponentType<short>(itk::IOComponentEnum::SHORT) ||
+        !CheckComponentType<unsigned short>(itk::IOComponentEnum::USHORT) ||
+        !CheckComponentType<int>(itk::IOComponentEnum::INT) ||
+        !CheckComponentType<unsigned int>(itk::IOComponentEnum::UINT) ||
+        !CheckComponentType<long long>(itk::IOComponentEnum::LONGLONG) ||
+        !CheckComponentType<unsigned long long>(itk::IOComponentEnum::ULONGLONG) ||
+        !CheckComponentType<float>(itk::IOComponentEnum::FLOAT) ||
+        !CheckComponentType<double>(itk::IOComponentEnum::DOUBLE))
+    {
+      std::cerr << "[ERROR] failed with " << name << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  itk::SCIFIOByteSwap::SetInstructionSet(best);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkSCIFIOFormatRegistry.h"
+#include "itkTimeProbe.h"
+
+#include <fstream>
+
+namespace
+{
+bool
+Expect(bool condition, const char * description)
+{
+  if (!condition)
+  {
+    std::cerr << "[ERROR] " << description << std::endl;
+  }
+  return condition;
+}
+} // namespace
+
+
+int
+itkSCIFIOFormatRegistryTest(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " inputFile outputDirectory\n";
+    return EXIT_FAILURE;
+  }
+  const std::string inputFile = argv[1];
+  const std::string directory = argv[2];
+
+  // a fake installation, and files with and without a known signature
+  itksys::SystemTools::RemoveADirectory(directory);
+  itksys::SystemTools::MakeDirectory(directory);
+  const std::string jarDirectory = directory + "/jars";
+  itksys::SystemTools::MakeDirectory(jarDirectory);
+  std::ofstream(jarDirectory + "/formats.jar") << "version 1";
+  const std::string signedFile = directory + "/signed.dat";
+  std::ofstream(signedFile, std::ios::binary) << "II*" << '\0' << "IFD";
+  const std::string plainFile = directory + "/plain.dat";
+  std::ofstream(plainFile, std::ios::binary) << "plain text";
+
+  using Registry = itk::SCIFIOFormatRegistry;
+  Registry::Clear();
+  bool ok = Expect(!Registry::Load(jarDirectory), "loaded formats that were never saved") &&
+            Expect(Registry::MightRead("image.nrrd"), "rejected a file before knowing the formats");
+
+  Registry::Register(jarDirectory,
+                     { "read", "tif", "read", "ome.tif", "read", "fake", "write", "ome.tif", "magic", "0 49492a00" });
+  ok = ok && Expect(Registry::MightRead("/data/IMAGE.TIF"), "suffixes are not case-insensitive") &&
+       Expect(Registry::MightRead("image.ome.tif"), "rejected a supported suffix") &&
+       Expect(Registry::MightRead("sizeX=1.5&sizeY=2.fake"), "rejected a synthetic image") &&
+       Expect(!Registry::MightRead("image.nrrd"), "accepted an unsupported suffix") &&
+       Expect(Registry::MightRead(signedFile), "rejected a known signature") &&
+       Expect(!Registry::MightRead(plainFile), "accepted an unknown signature") &&
+       Expect(Registry::MightWrite("image.ome.tif"), "rejected a supported output suffix") &&
+       Expect(!Registry::MightWrite("image.tif"), "accepted an unsupported output suffix");
+
+  bool canRead = false;
+  ok = ok && Expect(!Registry::FindCanRead(signedFile, canRead), "found a result that was never stored");
+  Registry::StoreCanRead(signedFile, true);
+  ok = ok && Expect(Registry::FindCanRead(signedFile, canRead) && canRead, "did not find a stored result");
+  std::ofstream(signedFile, std::ios::binary | std::ios::app) << "more";
+  ok = ok && Expect(!Registry::FindCanRead(signedFile, canRead), "found the result of a modified file");
+
+  // the saved formats survive the process, but not an upgrade
+  Registry::Clear();
+  ok = ok && Expect(Registry::Load(jarDirectory), "did not load the saved formats") &&
+       Expect(!Registry::MightRead("image.nrrd"), "lost the saved formats");
+  Registry::Clear();
+  std::ofstream(jarDirectory + "/formats.jar") << "version 2";
+  ok = ok && Expect(!Registry::Load(jarDirectory), "loaded the formats of other JAR files");
+  Registry::Clear();
+  if (!ok)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // with the real bridge: only the first probe of a file may need it
+  try
+  {
+    for (int i = 0; i < 2; ++i)
+    {
+      itk::TimeProbe probe;
+      probe.Start();
+      const bool canReadInput = itk::SCIFIOImageIO::New()->CanReadFile(inputFile.c_str());
+      const bool canReadOther = itk::SCIFIOImageIO::New()->CanReadFile((directory + "/image.nrrd").c_str());
+      probe.Stop();
+      std::cout << "Probe " << i << ": " << probe.GetTotal() << " s" << std::endl;
+      if (!Expect(canReadInput, "cannot read the input") || !Expect(!canReadOther, "can read a missing file"))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+
+    // a file never probed before, of a format SCIFIO does not support
+    const auto canReadCount = []() {
+      const itk::SCIFIOBridgeStatistics::CommandMapType commands =
+        itk::SCIFIOBridgeStatistics::GetProcessTotals().Commands;
+      const auto found = commands.find("canRead");
+      return found != commands.end() ? found->second.Count : 0;
+    };
+    const itk::SizeValueType before = canReadCount();
+    itk::SCIFIOImageIO::New()->CanReadFile((directory + "/other.nrrd").c_str());
+    const bool askedBridge = canReadCount() > before;
+    if (Registry::IsLoaded())
+    {
+      std::cout << "The bridge listed its formats" << std::endl;
+      if (!Expect(!askedBridge, "asked the bridge about an unsupported suffix"))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+    else
+    {
+      // legacy bridges, without the "formats" capability
+      std::cout << "The bridge cannot list its formats: new files are probed by the bridge" << std::endl;
+      if (!Expect(askedBridge, "rejected a file without knowing the formats"))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,345 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOByteSwap.h"
+#include "itkSCIFIOImageIO.h"
+#include "itkSCIFIOPixelConversion.h"
+#include "itkSCIFIOTestHelpers.h"
+#include "itkTimeProbe.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+/*
+ * One synthetic dataset of the sweep, and the number of stream divisions
+ * to read it in. Channels are grouped into pixels of RGBChannelCount
+ * components, stored in separate planes unless Interleaved.
+ */
+struct BenchmarkCase
+{
+  itk::SizeValueType SizeX;
+  itk::SizeValueType SizeY;
+  itk::SizeValueType SizeZ;
+  itk::SizeValueType SizeC;
+  std::string        PixelType;
+  int                SeriesCount;
+  unsigned int       Divisions;
+  unsigned int       RGBChannelCount;
+  bool               Interleaved;
+};
+
+std::string
+MakeFakeId(const BenchmarkCase & benchmarkCase)
+{
+  itk::SCIFIOTest::FakePropertiesType properties{ { "sizeX", std::to_string(benchmarkCase.SizeX) },
+                                                  { "sizeY", std::to_string(benchmarkCase.SizeY) },
+                                                  { "sizeZ", std::to_string(benchmarkCase.SizeZ) },
+                                                  { "sizeC", std::to_string(benchmarkCase.SizeC) },
+                                                  { "pixelType", benchmarkCase.PixelType },
+                                                  { "series", std::to_string(benchmarkCase.SeriesCount) } };
+  if (benchmarkCase.RGBChannelCount > 1)
+  {
+    properties.emplace_back("rgb", std::to_string(benchmarkCase.RGBChannelCount));
+    properties.emplace_back("interleaved", benchmarkCase.Interleaved ? "true" : "false");
+  }
+  return itk::SCIFIOTest::MakeFakeFileName("benchmark", properties);
+}
+
+itk::ImageIORegion
+GetLargestRegion(const itk::ImageIOBase * io)
+{
+  itk::ImageIORegion region(io->GetNumberOfDimensions());
+  for (unsigned int i = 0; i < io->GetNumberOfDimensions(); ++i)
+  {
+    region.SetIndex(i, 0);
+    region.SetSize(i, io->GetDimensions(i));
+  }
+  return region;
+}
+
+/*
+ * Reads every series of the file in the given number of pieces along the
+ * slowest axis, and returns the number of pixel bytes read.
+ */
+unsigned long long
+ReadSeries(itk::SCIFIOImageIO * io, const BenchmarkCase & benchmarkCase, unsigned int divisions)
+{
+  io->SetFileName(MakeFakeId(benchmarkCase));
+  unsigned long long bytes = 0;
+  std::vector<char>  buffer;
+  for (int series = 0; series < benchmarkCase.SeriesCount; ++series)
+  {
+    io->SetSeries(series);
+    io->ReadImageInformation();
+    const itk::ImageIORegion largest = GetLargestRegion(io);
+    const unsigned int       axis = largest.GetImageDimension() - 1;
+    const itk::SizeValueType length = largest.GetSize(axis);
+    const itk::SizeValueType pieces = std::min<itk::SizeValueType>(divisions, length);
+    for (itk::SizeValueType piece = 0; piece < pieces; ++piece)
+    {
+      itk::ImageIORegion region = largest;
+      const auto         begin = static_cast<itk::IndexValueType>(piece * length / pieces);
+      const auto         end = static_cast<itk::IndexValueType>((piece + 1) * length / pieces);
+      region.SetIndex(axis, begin);
+      region.SetSize(axis, end - begin);
+      io->SetIORegion(region);
+      buffer.resize(region.GetNumberOfPixels() * io->GetNumberOfComponents() * io->GetComponentSize());
+      io->Read(buffer.data());
+      bytes += buffer.size();
+    }
+  }
+  return bytes;
+}
+
+/*
+ * Writes one JSON object describing a measurement to each stream.
+ */
+void
+WriteRecord(std::ostream &                      out,
+            const std::string &                 operation,
+            const BenchmarkCase &               benchmarkCase,
+            double                              seconds,
+            unsigned long long                  bytes,
+            const itk::SCIFIOBridgeStatistics & statistics)
+{
+  std::ostringstream record;
+  record << "{\"operation\":\"" << operation << "\",\"sizeX\":" << benchmarkCase.SizeX
+         << ",\"sizeY\":" << benchmarkCase.SizeY << ",\"sizeZ\":" << benchmarkCase.SizeZ
+         << ",\"sizeC\":" << benchmarkCase.SizeC << ",\"pixelType\":\"" << benchmarkCase.PixelType
+         << "\",\"seriesCount\":" << benchmarkCase.SeriesCount << ",\"divisions\":" << benchmarkCase.Divisions
+         << ",\"rgbChannelCount\":" << benchmarkCase.RGBChannelCount
+         << ",\"interleaved\":" << (benchmarkCase.Interleaved ? "true" : "false")
+         << ",\"seconds\":" << seconds << ",\"bytes\":" << bytes
+         << ",\"megabytesPerSecond\":" << (seconds > 0.0 ? bytes / 1048576.0 / seconds : 0.0)
+         << ",\"spawnSeconds\":" << statistics.SpawnSeconds << ",\"bytesReceived\":" << statistics.BytesReceived
+         << ",\"bytesSent\":" << statistics.BytesSent << ",\"sharedMemoryBytes\":" << statistics.SharedMemoryBytes
+         << ",\"commands\":{";
+  bool first = true;
+  for (const auto & entry : statistics.Commands)
+  {
+    record << (first ? "" : ",") << "\"" << entry.first << "\":{\"count\":" << entry.second.Count
+           << ",\"totalSeconds\":" << entry.second.TotalSeconds
+           << ",\"maximumSeconds\":" << entry.second.MaximumSeconds << "}";
+    first = false;
+  }
+  record << "}}";
+
+  out << record.str() << std::endl;
+  std::cout << record.str() << std::endl;
+}
+} // namespace
+
+
+int
+itkSCIFIOImageIOBenchmark(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " results.jsonl outputDirectory\n";
+    return EXIT_FAILURE;
+  }
+  std::ofstream results(argv[1]);
+  if (!results)
+  {
+    std::cerr << "Cannot write to " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[2];
+  itksys::SystemTools::MakeDirectory(outputDirectory);
+
+  // vary one parameter at a time around a baseline
+  const BenchmarkCase        baseline{ 1024, 1024, 8, 1, "uint16", 1, 1, 1, true };
+  std::vector<BenchmarkCase> cases;
+  for (const itk::SizeValueType size : { 256, 1024, 2048 })
+  {
+    BenchmarkCase benchmarkCase = baseline;
+    benchmarkCase.SizeX = size;
+    benchmarkCase.SizeY = size;
+    cases.push_back(benchmarkCase);
+  }
+  for (const char * pixelType : { "uint8", "float", "double" })
+  {
+    BenchmarkCase benchmarkCase = baseline;
+    benchmarkCase.PixelType = pixelType;
+    cases.push_back(benchmarkCase);
+  }
+  for (const itk::SizeValueType channels : { 3, 8 })
+  {
+    BenchmarkCase benchmarkCase = baseline;
+    benchmarkCase.SizeC = channels;
+    cases.push_back(benchmarkCase);
+  }
+  for (const int seriesCount : { 4, 16 })
+  {
+    BenchmarkCase benchmarkCase = baseline;
+    benchmarkCase.SeriesCount = seriesCount;
+    cases.push_back(benchmarkCase);
+  }
+  for (const unsigned int divisions : { 4, 16 })
+  {
+    BenchmarkCase benchmarkCase = baseline;
+    benchmarkCase.Divisions = divisions;
+    cases.push_back(benchmarkCase);
+  }
+
+  // multi-component pixels stored as separate planes, read with and
+  // without interleaving them on the C++ side
+  std::vector<BenchmarkCase> planarCases;
+  for (const unsigned int channels : { 3, 4, 8 })
+  {
+    BenchmarkCase benchmarkCase = baseline;
+    benchmarkCase.SizeC = channels;
+    benchmarkCase.RGBChannelCount = channels;
+    benchmarkCase.Interleaved = false;
+    planarCases.push_back(benchmarkCase);
+  }
+
+  try
+  {
+    // startup: a fresh Java process for the first image information, with
+    // and without the class data sharing archive
+    for (const bool useClassDataArchive : { false, true })
+    {
+      itksys::SystemTools::PutEnv(std::string("SCIFIO_CLASS_DATA_ARCHIVE=") + (useClassDataArchive ? "1" : "0"));
+      itk::SCIFIOBridgePool::Clear();
+      itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+      io->UseMetaDataCacheOff();
+      io->SetFileName(MakeFakeId(baseline));
+      itk::TimeProbe probe;
+      probe.Start();
+      io->ReadImageInformation();
+      probe.Stop();
+      const std::string operation = io->GetUseClassDataArchive() ? "startupClassDataArchive" : "startup";
+      WriteRecord(results, operation, baseline, probe.GetTotal(), 0, io->GetBridgeStatistics());
+    }
+    itksys::SystemTools::UnPutEnv("SCIFIO_CLASS_DATA_ARCHIVE");
+
+    for (const auto & benchmarkCase : cases)
+    {
+      // whole images, or streamed in the given number of divisions
+      const std::string operation = benchmarkCase.Divisions > 1 ? "streamedRead" : "read";
+      itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+      io->UseMetaDataCacheOff();
+      itk::TimeProbe probe;
+      probe.Start();
+      const unsigned long long bytes = ReadSeries(io, benchmarkCase, benchmarkCase.Divisions);
+      probe.Stop();
+      WriteRecord(results, operation, benchmarkCase, probe.GetTotal(), bytes, io->GetBridgeStatistics());
+
+      if (benchmarkCase.Divisions > 1 || benchmarkCase.SeriesCount > 1)
+      {
+        continue;
+      }
+
+      // write back the first series; writes are never split
+      io->SetSeries(0);
+      io->ReadImageInformation();
+      const itk::ImageIORegion largest = GetLargestRegion(io);
+      std::vector<char>        buffer(io->GetImageSizeInBytes());
+      io->SetIORegion(largest);
+      io->Read(buffer.data());
+
+      itk::SCIFIOImageIO::Pointer writer = itk::SCIFIOImageIO::New();
+      writer->SetNumberOfDimensions(io->GetNumberOfDimensions());
+      for (unsigned int i = 0; i < io->GetNumberOfDimensions(); ++i)
+      {
+        writer->SetDimensions(i, io->GetDimensions(i));
+        writer->SetSpacing(i, 1.0);
+      }
+      writer->SetComponentType(io->GetComponentType());
+      writer->SetPixelType(io->GetPixelType());
+      writer->SetNumberOfComponents(io->GetNumberOfComponents());
+      writer->SetFileName(outputDirectory + "/benchmark_" + std::to_string(benchmarkCase.SizeX) + "_" +
+                          benchmarkCase.PixelType + "_" + std::to_string(benchmarkCase.SizeC) + ".ome.tif");
+      writer->SetIORegion(largest);
+      itk::TimeProbe writeProbe;
+      writeProbe.Start();
+      writer->WriteImageInformation();
+      writer->Write(buffer.data());
+      writeProbe.Stop();
+      WriteRecord(results, "write", benchmarkCase, writeProbe.GetTotal(), buffer.size(), writer->GetBridgeStatistics());
+    }
+
+    for (const auto & benchmarkCase : planarCases)
+    {
+      for (const bool useNativeLayout : { false, true })
+      {
+        itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+        io->UseMetaDataCacheOff();
+        io->SetUseNativeLayout(useNativeLayout);
+        itk::TimeProbe probe;
+        probe.Start();
+        const unsigned long long bytes = ReadSeries(io, benchmarkCase, benchmarkCase.Divisions);
+        probe.Stop();
+        WriteRecord(results,
+                    useNativeLayout ? "readNativeLayout" : "read",
+                    benchmarkCase,
+                    probe.GetTotal(),
+                    bytes,
+                    io->GetBridgeStatistics());
+      }
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // the interleaving alone, in memory, with the scalar and the shuffle
+  // kernels: one plane of each planar case, a few times over
+  using InstructionSetEnum = itk::SCIFIOByteSwap::InstructionSetEnum;
+  const InstructionSetEnum best = itk::SCIFIOByteSwap::GetInstructionSet();
+  for (const auto & benchmarkCase : planarCases)
+  {
+    const size_t      pixels = benchmarkCase.SizeX * benchmarkCase.SizeY;
+    const size_t      components = pixels * benchmarkCase.RGBChannelCount;
+    std::vector<char> source(components * sizeof(unsigned short), 1);
+    std::vector<char> destination(source.size());
+    for (const InstructionSetEnum instructionSet : { InstructionSetEnum::SCALAR, best })
+    {
+      itk::SCIFIOByteSwap::SetInstructionSet(instructionSet);
+      constexpr unsigned int repeats = 16;
+      itk::TimeProbe         probe;
+      probe.Start();
+      for (unsigned int i = 0; i < repeats; ++i)
+      {
+        itk::SCIFIOPixelConversion::ConvertPlanar(destination.data(),
+                                                  itk::ImageIOBase::IOComponentEnum::USHORT,
+                                                  source.data(),
+                                                  itk::ImageIOBase::IOComponentEnum::USHORT,
+                                                  benchmarkCase.RGBChannelCount,
+                                                  pixels,
+                                                  false);
+      }
+      probe.Stop();
+      WriteRecord(results,
+                  instructionSet == InstructionSetEnum::SCALAR ? "interleaveScalar" : "interleave",
+                  benchmarkCase,
+                  probe.GetTotal(),
+                  repeats * static_cast<unsigned long long>(destination.size()),
+                  itk::SCIFIOBridgeStatistics());
+    }
+  }
+  itk::SCIFIOByteSwap::SetInstructionSet(best);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImage.h"
+
+#include <fstream>
+
+int
+itkSCIFIOImageIOBridgeErrorTest(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " input corruptOutput\n";
+    return EXIT_FAILURE;
+  }
+  const char * fileName = argv[1];
+  const char * corruptFileName = argv[2];
+
+  // a TIFF header pointing to an image directory beyond the end of the file
+  {
+    std::ofstream corrupt(corruptFileName, std::ios::binary);
+    const char    header[] = { 'I', 'I', 42, 0, 0x10, 0x27, 0, 0 };
+    corrupt.write(header, sizeof(header));
+    corrupt << "not an image";
+  }
+
+  using ImageType = itk::Image<unsigned char, 2>;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+
+  itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+  io->UseMetaDataCacheOff();
+
+  // the bridge error reaches us as an exception, rather than ending the
+  // process
+  for (int i = 0; i < 2; ++i)
+  {
+    try
+    {
+      io->SetFileName(corruptFileName);
+      io->ReadImageInformation();
+      std::cerr << "[ERROR] read the information of a corrupt file" << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch (itk::SCIFIOBridgeExitException & e)
+    {
+      std::cerr << "[ERROR] the bridge exited instead of reporting the error: " << e << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch (itk::ExceptionObject & e)
+    {
+      std::cout << "Failed as expected:" << std::endl << e << std::endl;
+    }
+  }
+
+  // the next file is read with a new bridge
+  try
+  {
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetImageIO(io);
+    reader->SetFileName(fileName);
+    reader->Update();
+    std::cout << "Read " << reader->GetOutput()->GetLargestPossibleRegion() << std::endl;
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << "[ERROR] could not read a file after an error: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,145 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkSCIFIOTestHelpers.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Read a region of the image, in commands of at most maximumTransferSize
+// bytes
+std::vector<char>
+ReadRegion(itk::SCIFIOImageIO * io, const itk::ImageIORegion & region, itk::SizeValueType maximumTransferSize)
+{
+  io->SetMaximumTransferSize(maximumTransferSize);
+  io->SetIORegion(region);
+  std::vector<char> buffer(region.GetNumberOfPixels() * io->GetNumberOfComponents() * io->GetComponentSize());
+  io->Read(buffer.data());
+  return buffer;
+}
+} // namespace
+
+int
+itkSCIFIOImageIOLargeImageTest(int argc, char * argv[])
+{
+  if (argc < 5)
+  {
+    std::cerr << "Usage: " << argv[0] << " sizeX sizeY sizeZ pixelType [wholeImage]\n";
+    return EXIT_FAILURE;
+  }
+  const unsigned long long sizeX = std::stoull(argv[1]);
+  const unsigned long long sizeY = std::stoull(argv[2]);
+  const unsigned long long sizeZ = std::stoull(argv[3]);
+  const std::string        pixelType = argv[4];
+  const bool               wholeImage = argc > 5 && std::string(argv[5]) == "1";
+
+  const std::string id = itk::SCIFIOTest::MakeFakeFileName(
+    "large", { { "pixelType", pixelType }, { "sizeX", argv[1] }, { "sizeY", argv[2] }, { "sizeZ", argv[3] } });
+
+  try
+  {
+    itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+    if ((pixelType == "int64" || pixelType == "uint64") && !io->HasBridgeCapability("int64"))
+    {
+      std::cout << "The bridge does not support 64-bit integer pixels" << std::endl;
+      return itk::SCIFIOTest::SkipReturnCode;
+    }
+    io->SetFileName(id);
+    io->ReadImageInformation();
+    const itk::SizeValueType maximumTransferSize = io->GetMaximumTransferSize();
+    const size_t             pixelBytes = io->GetNumberOfComponents() * io->GetComponentSize();
+    std::cout << io->GetImageSizeInPixels() << " pixels, " << io->GetImageSizeInBytes() << " bytes" << std::endl;
+
+    // sizes beyond 32 bits come through whole
+    if (io->GetImageSizeInPixels() != sizeX * sizeY * sizeZ)
+    {
+      std::cerr << "[ERROR] expected " << sizeX * sizeY * sizeZ << " pixels" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if ((pixelType == "int64" && io->GetComponentType() != itk::IOComponentEnum::LONGLONG) ||
+        (pixelType == "uint64" && io->GetComponentType() != itk::IOComponentEnum::ULONGLONG))
+    {
+      std::cerr << "[ERROR] " << pixelType << " pixels read as "
+                << itk::ImageIOBase::GetComponentTypeAsString(io->GetComponentType()) << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // the far corner of the last plane, at offsets beyond 2^31 pixels if
+    // the image is that large, in one command and a row at a time
+    const unsigned int dimension = io->GetNumberOfDimensions();
+    itk::ImageIORegion corner(dimension);
+    for (unsigned int d = 0; d < dimension; ++d)
+    {
+      const itk::SizeValueType size = std::min<itk::SizeValueType>(io->GetDimensions(d), d < 2 ? 64 : 1);
+      corner.SetIndex(d, io->GetDimensions(d) - size);
+      corner.SetSize(d, size);
+    }
+    const std::vector<char> reference = ReadRegion(io, corner, maximumTransferSize);
+    const size_t            rowBytes = corner.GetSize(0) * pixelBytes;
+    if (ReadRegion(io, corner, rowBytes) != reference)
+    {
+      std::cerr << "[ERROR] the corner differs when read a row at a time" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    if (wholeImage)
+    {
+      // the whole image in a single buffer, beyond 2^31 bytes if the image
+      // is that large, in pieces of at most a third of it
+      itk::ImageIORegion largest(dimension);
+      for (unsigned int d = 0; d < dimension; ++d)
+      {
+        largest.SetIndex(d, 0);
+        largest.SetSize(d, io->GetDimensions(d));
+      }
+      const itk::SizeValueType imageBytes = io->GetImageSizeInBytes();
+      const std::vector<char>  image =
+        ReadRegion(io, largest, std::min<itk::SizeValueType>(maximumTransferSize, imageBytes / 3 + 1));
+
+      // compare its corner, row by row
+      const itk::SizeValueType rows = corner.GetNumberOfPixels() / corner.GetSize(0);
+      for (itk::SizeValueType row = 0; row < rows; ++row)
+      {
+        size_t offset = 0;
+        size_t stride = pixelBytes;
+        for (unsigned int d = 0; d < dimension; ++d)
+        {
+          const itk::SizeValueType index = corner.GetIndex(d) + (d == 1 ? row : 0);
+          offset += index * stride;
+          stride *= io->GetDimensions(d);
+        }
+        if (memcmp(&image[offset], &reference[row * rowBytes], rowBytes) != 0)
+        {
+          std::cerr << "[ERROR] row " << row << " of the corner differs in the whole image" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkSCIFIOBridgePool.h"
+#include "itkSCIFIOTestHelpers.h"
+#include "itkImageFileReader.h"
+#include "itkImage.h"
+
+int
+itkSCIFIOImageIOMemoryBudgetTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " size\n";
+    return EXIT_FAILURE;
+  }
+  const std::string size(argv[1]);
+
+  const std::string id =
+    itk::SCIFIOTest::MakeFakeFileName("budget", { { "pixelType", "uint16" }, { "sizeX", size }, { "sizeY", size } });
+
+  using ImageType = itk::Image<unsigned short, 2>;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+
+  try
+  {
+    // a plane of a few hundred megabytes does not fit in the initial heap
+    itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+    io->SetMemoryBudget(4096);
+    const itk::SizeValueType initialHeapSize = io->GetJavaHeapSize();
+
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetImageIO(io);
+    reader->SetFileName(id);
+    reader->Update();
+
+    std::cout << "Heap: " << initialHeapSize << " MB, then " << io->GetJavaHeapSize() << " MB" << std::endl;
+    const itk::SizeValueType planeMegabytes = reader->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels() *
+                                              sizeof(ImageType::PixelType) / (1024 * 1024);
+    if (planeMegabytes > initialHeapSize && io->GetJavaHeapSize() <= planeMegabytes)
+    {
+      std::cerr << "[ERROR] the heap did not grow for a plane of " << planeMegabytes << " MB" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (io->GetJavaHeapSize() > io->GetMemoryBudget())
+    {
+      std::cerr << "[ERROR] the heap exceeds the memory budget" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // the grown heap goes back to the pool: a new instance reuses it for
+    // a smaller need, rather than starting a Java process with less
+    const itk::SizeValueType grownHeapSize = io->GetJavaHeapSize();
+    reader = nullptr;
+    io = nullptr;
+    if (itk::SCIFIOBridgePool::GetMaximumNumberOfIdleWorkers() > 0)
+    {
+      itk::SCIFIOImageIO::Pointer reuseIO = itk::SCIFIOImageIO::New();
+      reuseIO->SetMemoryBudget(4096);
+      reuseIO->SetFileName(id);
+      reuseIO->ReadImageInformation();
+      std::cout << "Reused heap: " << reuseIO->GetJavaHeapSize() << " MB" << std::endl;
+      if (reuseIO->GetBridgeStatistics().NumberOfSpawns != 0 || reuseIO->GetJavaHeapSize() != grownHeapSize)
+      {
+        std::cerr << "[ERROR] started a Java process instead of reusing the one with a " << grownHeapSize
+                  << " MB heap" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // a smaller budget caps the heap, and keeps the larger one of the pool
+    // out of reach: a plane larger than the budget cannot be read, one
+    // leaving room for the bridge can
+    const itk::SizeValueType    smallBudget = 256;
+    itk::SCIFIOImageIO::Pointer smallIO = itk::SCIFIOImageIO::New();
+    smallIO->SetMemoryBudget(smallBudget);
+    reader = ReaderType::New();
+    reader->SetImageIO(smallIO);
+    reader->SetFileName(id);
+    bool outOfMemory = false;
+    try
+    {
+      reader->Update();
+    }
+    catch (itk::MemoryAllocationError & e)
+    {
+      std::cout << "Out of memory within the budget:" << std::endl << e << std::endl;
+      outOfMemory = true;
+    }
+    if (smallIO->GetJavaHeapSize() > smallBudget)
+    {
+      std::cerr << "[ERROR] the heap exceeds the memory budget" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (planeMegabytes >= smallBudget && !outOfMemory)
+    {
+      std::cerr << "[ERROR] read a plane of " << planeMegabytes << " MB within a budget of " << smallBudget << " MB"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (128 + 3 * planeMegabytes <= smallBudget && outOfMemory)
+    {
+      std::cerr << "[ERROR] could not read a plane of " << planeMegabytes << " MB within a budget of "
+                << smallBudget << " MB" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
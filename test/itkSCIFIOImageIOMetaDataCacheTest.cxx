@@ -0,0 +1,196 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImage.h"
+#include "itkMetaDataObject.h"
+#include "itksys/Directory.hxx"
+#include "itksys/SystemTools.hxx"
+
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+namespace
+{
+/*
+ * Reads the image information of the file with a fresh SCIFIOImageIO,
+ * using the metadata cache.
+ */
+itk::SCIFIOImageIO::Pointer
+ReadInformation(const char * fileName)
+{
+  itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+  io->UseMetaDataCacheOn();
+  io->SetFileName(fileName);
+  io->ReadImageInformation();
+  return io;
+}
+
+// Whether the bridge was asked for the image information
+bool
+AskedBridge(itk::SCIFIOImageIO * io)
+{
+  return io->GetBridgeStatistics().Commands.count("info") > 0;
+}
+
+bool
+CompareInformation(itk::SCIFIOImageIO * expected, itk::SCIFIOImageIO * actual)
+{
+  if (expected->GetNumberOfDimensions() != actual->GetNumberOfDimensions() ||
+      expected->GetComponentType() != actual->GetComponentType() ||
+      expected->GetPixelType() != actual->GetPixelType() || expected->GetByteOrder() != actual->GetByteOrder() ||
+      expected->GetNumberOfComponents() != actual->GetNumberOfComponents())
+  {
+    std::cerr << "[ERROR] core fields differ" << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < expected->GetNumberOfDimensions(); ++i)
+  {
+    if (expected->GetDimensions(i) != actual->GetDimensions(i) || expected->GetSpacing(i) != actual->GetSpacing(i))
+    {
+      std::cerr << "[ERROR] dimension " << i << " differs" << std::endl;
+      return false;
+    }
+  }
+
+  const itk::MetaDataDictionary & expectedDict = expected->GetMetaDataDictionary();
+  const itk::MetaDataDictionary & actualDict = actual->GetMetaDataDictionary();
+  const std::vector<std::string>  keys = expectedDict.GetKeys();
+  if (keys.size() != actualDict.GetKeys().size())
+  {
+    std::cerr << "[ERROR] dictionaries have " << keys.size() << " and " << actualDict.GetKeys().size() << " keys"
+              << std::endl;
+    return false;
+  }
+  for (const auto & key : keys)
+  {
+    std::string expectedValue;
+    std::string actualValue;
+    itk::ExposeMetaData<std::string>(expectedDict, key, expectedValue);
+    if (!itk::ExposeMetaData<std::string>(actualDict, key, actualValue) || expectedValue != actualValue)
+    {
+      std::cerr << "[ERROR] " << key << " does not match: expected=" << expectedValue << "; actual=" << actualValue
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+
+int
+itkSCIFIOImageIOMetaDataCacheTest(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " input cacheDirectory\n";
+    return EXIT_FAILURE;
+  }
+  const char * fileName = argv[1];
+  const char * cacheDirectory = argv[2];
+
+  itksys::SystemTools::RemoveADirectory(cacheDirectory);
+  itk::SCIFIOMetaDataCache::SetDirectory(cacheDirectory);
+
+  try
+  {
+    // cache miss: asks the bridge, and fills both tiers
+    itk::SCIFIOImageIO::Pointer reference = itk::SCIFIOImageIO::New();
+    reference->UseMetaDataCacheOff();
+    reference->SetFileName(fileName);
+    reference->ReadImageInformation();
+    itk::SCIFIOImageIO::Pointer first = ReadInformation(fileName);
+    if (!CompareInformation(reference, first))
+    {
+      return EXIT_FAILURE;
+    }
+    if (!AskedBridge(first))
+    {
+      std::cerr << "[ERROR] the first read did not ask the bridge" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    itksys::Directory directory;
+    directory.Load(cacheDirectory);
+    // "." and ".." and the entry
+    if (directory.GetNumberOfFiles() != 3)
+    {
+      std::cerr << "[ERROR] expected a single entry in " << cacheDirectory << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // memory tier hit
+    itk::SCIFIOImageIO::Pointer second = ReadInformation(fileName);
+    if (!CompareInformation(reference, second))
+    {
+      return EXIT_FAILURE;
+    }
+    if (AskedBridge(second))
+    {
+      std::cerr << "[ERROR] the memory tier missed" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // disk tier hit
+    itk::SCIFIOMetaDataCache::Clear();
+    itk::SCIFIOImageIO::Pointer third = ReadInformation(fileName);
+    if (!CompareInformation(reference, third))
+    {
+      return EXIT_FAILURE;
+    }
+    if (AskedBridge(third))
+    {
+      std::cerr << "[ERROR] the disk tier missed" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // the pixels can still be read after a cache hit
+    using ImageType = itk::Image<unsigned char, 2>;
+    using ReaderType = itk::ImageFileReader<ImageType>;
+    ReaderType::Pointer         reader = ReaderType::New();
+    itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+    io->UseMetaDataCacheOn();
+    reader->SetImageIO(io);
+    reader->SetFileName(fileName);
+    reader->Update();
+    std::cout << "Read " << reader->GetOutput()->GetLargestPossibleRegion() << std::endl;
+
+#ifndef _WIN32
+    // a rewrite of the same size within the same second changes the stamp
+    const std::string rewritten = std::string(cacheDirectory) + "/rewritten.txt";
+    std::ofstream(rewritten.c_str()) << "first";
+    const std::string stamp = itk::SCIFIOMetaDataCache::GetFileStamp(rewritten);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::ofstream(rewritten.c_str()) << "other";
+    if (stamp.empty() || stamp == itk::SCIFIOMetaDataCache::GetFileStamp(rewritten))
+    {
+      std::cerr << "[ERROR] rewriting " << rewritten << " did not change its stamp" << std::endl;
+      return EXIT_FAILURE;
+    }
+#endif
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
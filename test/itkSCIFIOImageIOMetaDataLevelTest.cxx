@@ -0,0 +1,153 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkMetaDataObject.h"
+
+namespace
+{
+itk::SCIFIOImageIO::Pointer
+ReadInformation(const char * fileName, itk::SCIFIOImageIO::MetaDataLevelEnum level)
+{
+  itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+  io->UseMetaDataCacheOff();
+  io->SetMetaDataLevel(level);
+  io->SetFileName(fileName);
+  io->ReadImageInformation();
+  return io;
+}
+
+bool
+CompareSizes(itk::SCIFIOImageIO * expected, itk::SCIFIOImageIO * actual)
+{
+  if (expected->GetNumberOfDimensions() != actual->GetNumberOfDimensions() ||
+      expected->GetComponentType() != actual->GetComponentType() ||
+      expected->GetNumberOfComponents() != actual->GetNumberOfComponents())
+  {
+    std::cerr << "[ERROR] core fields differ" << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < expected->GetNumberOfDimensions(); ++i)
+  {
+    if (expected->GetDimensions(i) != actual->GetDimensions(i) || expected->GetSpacing(i) != actual->GetSpacing(i))
+    {
+      std::cerr << "[ERROR] dimension " << i << " differs" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+
+int
+itkSCIFIOImageIOMetaDataLevelTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " input\n";
+    return EXIT_FAILURE;
+  }
+  const char * fileName = argv[1];
+
+  using LevelEnum = itk::SCIFIOImageIO::MetaDataLevelEnum;
+
+  try
+  {
+    itk::SCIFIOImageIO::Pointer    full = ReadInformation(fileName, LevelEnum::FULL);
+    const std::vector<std::string> fullKeys = full->GetMetaDataDictionary().GetKeys();
+
+    // only the core fields
+    itk::SCIFIOImageIO::Pointer core = ReadInformation(fileName, LevelEnum::CORE);
+    if (!CompareSizes(full, core))
+    {
+      return EXIT_FAILURE;
+    }
+    const std::vector<std::string> coreKeys = core->GetMetaDataDictionary().GetKeys();
+    for (const auto & key : coreKeys)
+    {
+      if (!itk::SCIFIOCoreMetaData::IsCoreKey(key))
+      {
+        std::cerr << "[ERROR] " << key << " read at the core level" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    std::cout << fullKeys.size() << " keys in full, " << coreKeys.size() << " at the core level" << std::endl;
+
+    // the core fields, and one exact key and one prefix of the others
+    std::vector<std::string> others;
+    for (const auto & key : fullKeys)
+    {
+      if (!itk::SCIFIOCoreMetaData::IsCoreKey(key))
+      {
+        others.push_back(key);
+      }
+    }
+    if (!others.empty())
+    {
+      const std::string           prefix = others.back().substr(0, 1);
+      itk::SCIFIOImageIO::Pointer filtered = itk::SCIFIOImageIO::New();
+      filtered->UseMetaDataCacheOff();
+      filtered->SetMetaDataLevel(LevelEnum::FILTERED);
+      filtered->SetMetaDataFilter({ others.front(), prefix + "*" });
+      filtered->SetFileName(fileName);
+      filtered->ReadImageInformation();
+      if (!CompareSizes(full, filtered))
+      {
+        return EXIT_FAILURE;
+      }
+      const itk::MetaDataDictionary & dict = filtered->GetMetaDataDictionary();
+      for (const auto & key : others)
+      {
+        const bool selected = key == others.front() || key.compare(0, prefix.size(), prefix) == 0;
+        if (dict.HasKey(key) != selected)
+        {
+          std::cerr << "[ERROR] " << key << (selected ? " missing" : " not filtered out") << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // the rest is fetched on demand
+    const itk::MetaDataDictionary & fullDict = full->GetMetaDataDictionary();
+    const itk::MetaDataDictionary & lazyDict = core->GetFullMetaDataDictionary();
+    if (lazyDict.GetKeys().size() != fullKeys.size())
+    {
+      std::cerr << "[ERROR] expected " << fullKeys.size() << " keys, got " << lazyDict.GetKeys().size() << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (const auto & key : fullKeys)
+    {
+      std::string expectedValue;
+      std::string actualValue;
+      itk::ExposeMetaData<std::string>(fullDict, key, expectedValue);
+      if (!itk::ExposeMetaData<std::string>(lazyDict, key, actualValue) || expectedValue != actualValue)
+      {
+        std::cerr << "[ERROR] " << key << " does not match: expected=" << expectedValue << "; actual=" << actualValue
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
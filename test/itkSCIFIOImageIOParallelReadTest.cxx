@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkSCIFIOTestHelpers.h"
+#include "itkImageFileReader.h"
+#include "itkImage.h"
+
+namespace
+{
+using PixelType = unsigned short;
+constexpr unsigned int Dimension = 5;
+using ImageType = itk::Image<PixelType, Dimension>;
+using ReaderType = itk::ImageFileReader<ImageType>;
+
+/*
+ * Reads the image with the given number of workers, through the pipes, so
+ * that each worker sends a single read command.
+ */
+ReaderType::Pointer
+MakeReader(const std::string & fileName, unsigned int numberOfWorkers)
+{
+  itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+  io->SetNumberOfReadWorkers(numberOfWorkers);
+  io->UseSharedMemoryOff();
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO(io);
+  reader->SetFileName(fileName);
+  return reader;
+}
+
+itk::SizeValueType
+GetNumberOfReadCommands(ReaderType * reader)
+{
+  const auto * io = static_cast<const itk::SCIFIOImageIO *>(reader->GetImageIO());
+  const auto   commands = io->GetBridgeStatistics().Commands;
+  const auto   read = commands.find("read");
+  return read == commands.end() ? 0 : read->second.Count;
+}
+} // namespace
+
+
+int
+itkSCIFIOImageIOParallelReadTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " numberOfWorkers [sizeX sizeY sizeZ sizeT sizeC]\n";
+    return EXIT_FAILURE;
+  }
+  const unsigned int numberOfWorkers = atoi(argv[1]);
+
+  const char * names[] = { "sizeX", "sizeY", "sizeZ", "sizeT", "sizeC" };
+  const char * sizes[] = { "256", "256", "12", "5", "3" };
+  itk::SCIFIOTest::FakePropertiesType properties{ { "pixelType", "uint16" } };
+  for (unsigned int i = 0; i < Dimension; ++i)
+  {
+    properties.emplace_back(names[i], 2 + i < static_cast<unsigned int>(argc) ? argv[2 + i] : sizes[i]);
+  }
+  const std::string id = itk::SCIFIOTest::MakeFakeFileName("parallelRead", properties);
+
+  try
+  {
+    ReaderType::Pointer serial = MakeReader(id, 1);
+    ReaderType::Pointer parallel = MakeReader(id, numberOfWorkers);
+    const double        serialTime = itk::SCIFIOTest::TimeUpdate(serial.GetPointer());
+    const double        parallelTime = itk::SCIFIOTest::TimeUpdate(parallel.GetPointer());
+
+    std::cout << "Read " << serial->GetOutput()->GetLargestPossibleRegion().GetSize() << std::endl;
+    std::cout << "\t1 worker: " << serialTime << " s" << std::endl;
+    std::cout << "\t" << numberOfWorkers << " workers: " << parallelTime << " s" << std::endl;
+
+    if (!itk::SCIFIOTest::HaveSamePixels(serial->GetOutput(), parallel->GetOutput()))
+    {
+      return EXIT_FAILURE;
+    }
+
+    // one read per worker
+    const itk::SizeValueType serialReads = GetNumberOfReadCommands(serial);
+    const itk::SizeValueType parallelReads = GetNumberOfReadCommands(parallel);
+    std::cout << "\tread commands: " << serialReads << " and " << parallelReads << std::endl;
+    if (serialReads != 1 || parallelReads != numberOfWorkers)
+    {
+      std::cerr << "[ERROR] expected 1 and " << numberOfWorkers << " read commands" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
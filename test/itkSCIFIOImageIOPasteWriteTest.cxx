@@ -0,0 +1,133 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkSCIFIOTestHelpers.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+
+namespace
+{
+using PixelType = unsigned short;
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<PixelType, Dimension>;
+using WriterType = itk::ImageFileWriter<ImageType>;
+
+ImageType::Pointer
+MakeImage(const ImageType::SizeType & size, PixelType seed)
+{
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(ImageType::RegionType(size));
+  image->Allocate();
+  itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion());
+  PixelType                           value = seed;
+  for (; !it.IsAtEnd(); ++it)
+  {
+    it.Set(value);
+    value = static_cast<PixelType>(value * 31 + 7);
+  }
+  return image;
+}
+} // namespace
+
+
+int
+itkSCIFIOImageIOPasteWriteTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " output\n";
+    return EXIT_FAILURE;
+  }
+  const char * fileName = argv[1];
+
+  ImageType::SizeType size;
+  size[0] = 64;
+  size[1] = 48;
+  size[2] = 8;
+  ImageType::Pointer original = MakeImage(size, 0);
+  ImageType::Pointer pasted = MakeImage(size, 1);
+
+  // planes 3 and 4 of the second image, over the first one
+  itk::ImageIORegion paste(Dimension);
+  paste.SetIndex(0, 0);
+  paste.SetSize(0, size[0]);
+  paste.SetIndex(1, 0);
+  paste.SetSize(1, size[1]);
+  paste.SetIndex(2, 3);
+  paste.SetSize(2, 2);
+
+  try
+  {
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetImageIO(itk::SCIFIOImageIO::New());
+    writer->SetInput(original);
+    writer->SetFileName(fileName);
+    writer->Update();
+
+    itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+    WriterType::Pointer         pasteWriter = WriterType::New();
+    pasteWriter->SetImageIO(io);
+    pasteWriter->SetInput(pasted);
+    pasteWriter->SetFileName(fileName);
+    pasteWriter->SetIORegion(paste);
+    pasteWriter->Update();
+
+    // one plane sent per plane of the paste region
+    const auto commands = io->GetBridgeStatistics().Commands;
+    const auto planes = commands.find("plane");
+    if (commands.count("writeShm") > 0 && (planes == commands.end() || planes->second.Count != paste.GetSize(2)))
+    {
+      std::cerr << "[ERROR] expected " << paste.GetSize(2) << " planes, sent "
+                << (planes == commands.end() ? 0 : planes->second.Count) << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    using ReaderType = itk::ImageFileReader<ImageType>;
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetImageIO(itk::SCIFIOImageIO::New());
+    reader->SetFileName(fileName);
+    reader->Update();
+
+    ImageType::RegionType pasteRegion;
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      pasteRegion.SetIndex(d, paste.GetIndex(d));
+      pasteRegion.SetSize(d, paste.GetSize(d));
+    }
+    ImageType::RegionType before = original->GetLargestPossibleRegion();
+    before.SetSize(2, paste.GetIndex(2));
+    ImageType::RegionType after = original->GetLargestPossibleRegion();
+    after.SetIndex(2, paste.GetIndex(2) + paste.GetSize(2));
+    after.SetSize(2, size[2] - after.GetIndex(2));
+    if (!itk::SCIFIOTest::HaveSamePixels(pasted.GetPointer(), reader->GetOutput(), pasteRegion) ||
+        !itk::SCIFIOTest::HaveSamePixels(original.GetPointer(), reader->GetOutput(), before) ||
+        !itk::SCIFIOTest::HaveSamePixels(original.GetPointer(), reader->GetOutput(), after))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,96 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkSCIFIOTestHelpers.h"
+#include "itkImageFileReader.h"
+#include "itkImage.h"
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+/*
+ * Reads the image as float, converted by the reader or by the ImageIO,
+ * through the pipes or through shared memory.
+ */
+ImageType::Pointer
+ReadImage(const std::string & fileName, bool convertInImageIO, bool useSharedMemory, double & seconds)
+{
+  itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+  io->SetUseSharedMemory(useSharedMemory);
+  if (convertInImageIO)
+  {
+    io->SetTargetComponentType(itk::IOComponentEnum::FLOAT);
+  }
+
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO(io);
+  reader->SetFileName(fileName);
+  seconds = itk::SCIFIOTest::TimeUpdate(reader.GetPointer());
+
+  const itk::IOComponentEnum expected =
+    convertInImageIO ? itk::IOComponentEnum::FLOAT : itk::IOComponentEnum::USHORT;
+  if (io->GetComponentType() != expected)
+  {
+    itkGenericExceptionMacro(<< "ImageIO reports the component type "
+                             << itk::ImageIOBase::GetComponentTypeAsString(io->GetComponentType()));
+  }
+  return reader->GetOutput();
+}
+} // namespace
+
+
+int
+itkSCIFIOImageIOPixelConversionTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " size\n";
+    return EXIT_FAILURE;
+  }
+
+  const std::string id = itk::SCIFIOTest::MakeFakeFileName(
+    "conversion", { { "pixelType", "uint16" }, { "sizeX", argv[1] }, { "sizeY", argv[1] }, { "sizeZ", "4" } });
+
+  try
+  {
+    double             readerTime;
+    ImageType::Pointer expected = ReadImage(id, false, true, readerTime);
+    std::cout << "Converted by the reader: " << readerTime << " s" << std::endl;
+
+    for (const bool useSharedMemory : { true, false })
+    {
+      double             fusedTime;
+      ImageType::Pointer converted = ReadImage(id, true, useSharedMemory, fusedTime);
+      std::cout << "Converted by the ImageIO, " << (useSharedMemory ? "shared memory" : "pipes") << ": " << fusedTime
+                << " s" << std::endl;
+      if (!itk::SCIFIOTest::HaveSamePixels(expected.GetPointer(), converted.GetPointer()))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
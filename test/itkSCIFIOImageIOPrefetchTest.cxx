@@ -0,0 +1,104 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkSCIFIOTestHelpers.h"
+#include "itkImageFileReader.h"
+#include "itkImage.h"
+#include "itkStreamingImageFilter.h"
+
+namespace
+{
+using PixelType = unsigned short;
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<PixelType, Dimension>;
+using StreamingFilter = itk::StreamingImageFilter<ImageType, ImageType>;
+
+/*
+ * Streams the image through the reader in the given number of divisions.
+ */
+StreamingFilter::Pointer
+MakeStreamer(const std::string & fileName, unsigned int numberOfDivisions, itk::SCIFIOImageIO * io)
+{
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO(io);
+  reader->SetFileName(fileName);
+
+  StreamingFilter::Pointer streamer = StreamingFilter::New();
+  streamer->SetInput(reader->GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfDivisions);
+  return streamer;
+}
+} // namespace
+
+
+int
+itkSCIFIOImageIOPrefetchTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " numberOfDivisions [sizeX sizeY sizeZ]\n";
+    return EXIT_FAILURE;
+  }
+  const unsigned int numberOfDivisions = atoi(argv[1]);
+
+  const char * names[] = { "sizeX", "sizeY", "sizeZ" };
+  const char * sizes[] = { "512", "512", "32" };
+  itk::SCIFIOTest::FakePropertiesType properties{ { "pixelType", "uint16" } };
+  for (unsigned int i = 0; i < Dimension; ++i)
+  {
+    properties.emplace_back(names[i], 2 + i < static_cast<unsigned int>(argc) ? argv[2 + i] : sizes[i]);
+  }
+  const std::string id = itk::SCIFIOTest::MakeFakeFileName("prefetch", properties);
+
+  try
+  {
+    itk::SCIFIOImageIO::Pointer prefetchingIO = itk::SCIFIOImageIO::New();
+    prefetchingIO->UsePrefetchOn();
+    StreamingFilter::Pointer cold = MakeStreamer(id, numberOfDivisions, itk::SCIFIOImageIO::New());
+    StreamingFilter::Pointer prefetched = MakeStreamer(id, numberOfDivisions, prefetchingIO);
+    const double             coldTime = itk::SCIFIOTest::TimeUpdate(cold.GetPointer());
+    const double             prefetchTime = itk::SCIFIOTest::TimeUpdate(prefetched.GetPointer());
+
+    std::cout << "Streamed " << cold->GetOutput()->GetLargestPossibleRegion().GetSize() << " in "
+              << numberOfDivisions << " divisions" << std::endl;
+    std::cout << "\twithout prefetch: " << coldTime << " s" << std::endl;
+    std::cout << "\twith prefetch: " << prefetchTime << " s" << std::endl;
+
+    if (!itk::SCIFIOTest::HaveSamePixels(cold->GetOutput(), prefetched->GetOutput()))
+    {
+      return EXIT_FAILURE;
+    }
+
+    // the divisions after the first were read in the background
+    std::cout << "\tprefetch: " << prefetchingIO->GetPrefetchHits() << " hits, "
+              << prefetchingIO->GetPrefetchMisses() << " misses" << std::endl;
+    if (prefetchingIO->GetPrefetchHits() == 0 || prefetchingIO->GetPrefetchMisses() != 0)
+    {
+      std::cerr << "[ERROR] expected prefetch hits and no misses" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
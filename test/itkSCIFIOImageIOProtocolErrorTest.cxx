@@ -0,0 +1,113 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkSCIFIOBridgePool.h"
+#include "itkSCIFIOTestHelpers.h"
+
+#include <fstream>
+
+namespace
+{
+// Stands in for the Java bridge: negotiates binary framing, then answers
+// the first command with the header chosen by SCIFIO_FAKE_BRIDGE_REPLY,
+// and stays alive
+const char fakeBridge[] = "#!/bin/sh\n"
+                          "while read -r line; do\n"
+                          "  case \"$line\" in\n"
+                          "    capabilities) printf 'SCIFIOITKBridge\\t0\\nbinary\\n\\n' ;;\n"
+                          "    canWrite*) printf 'false\\n\\n' ;;\n"
+                          "    binary) printf 'binary\\n\\n'; break ;;\n"
+                          "  esac\n"
+                          "done\n"
+                          "dd bs=1 count=1 >/dev/null 2>&1\n"
+                          "if [ \"$SCIFIO_FAKE_BRIDGE_REPLY\" = magic ]; then\n"
+                          "  printf 'JUNK\\001\\000\\002\\000\\001\\000\\000\\000'\n"
+                          "  printf '\\000\\000\\000\\000\\000\\000\\000\\000'\n"
+                          "else\n"
+                          "  printf 'SCIF\\001\\000\\002\\000\\143\\000\\000\\000'\n"
+                          "  printf '\\000\\000\\000\\000\\000\\000\\000\\000'\n"
+                          "fi\n"
+                          "exec cat >/dev/null\n";
+
+/*
+ * Asks the fake bridge for the information of an image, and checks that
+ * the reply is rejected and the worker is not handed back to the pool.
+ */
+bool
+CheckWorkerDiscarded(const std::string & reply)
+{
+  itksys::SystemTools::PutEnv("SCIFIO_FAKE_BRIDGE_REPLY=" + reply);
+
+  itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+  io->UseMetaDataCacheOff();
+  io->SetFileName(itk::SCIFIOTest::MakeFakeFileName("protocolError", { { "sizeX", "16" }, { "sizeY", "16" } }));
+  try
+  {
+    io->ReadImageInformation();
+    std::cerr << "[ERROR] accepted a " << reply << " reply" << std::endl;
+    return false;
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cout << "Failed as expected on a " << reply << " reply:" << std::endl << e << std::endl;
+  }
+
+  io = nullptr;
+  if (itk::SCIFIOBridgePool::GetNumberOfIdleWorkers() != 0)
+  {
+    std::cerr << "[ERROR] the worker of a " << reply << " reply is back in the pool" << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+
+int
+itkSCIFIOImageIOProtocolErrorTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory\n";
+    return EXIT_FAILURE;
+  }
+#if defined(_WIN32)
+  std::cout << "The fake bridge is a shell script" << std::endl;
+  return itk::SCIFIOTest::SkipReturnCode;
+#else
+  // the Java runtime found in JAVA_HOME is the fake bridge
+  const std::string javaHome = std::string(argv[1]) + "/fake_java";
+  itksys::SystemTools::MakeDirectory(javaHome + "/bin");
+  const std::string java = javaHome + "/bin/java";
+  {
+    std::ofstream script(java.c_str());
+    script << fakeBridge;
+  }
+  itksys::SystemTools::SetPermissions(java, 0755);
+  itksys::SystemTools::PutEnv("JAVA_HOME=" + javaHome);
+  itksys::SystemTools::PutEnv("SCIFIO_BRIDGE_EXTENSIONS=1");
+  itk::SCIFIOBridgePool::SetMaximumNumberOfIdleWorkers(2);
+
+  // a reply to another request, and a header that is not a frame at all
+  if (!CheckWorkerDiscarded("mismatch") || !CheckWorkerDiscarded("magic"))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+#endif
+}
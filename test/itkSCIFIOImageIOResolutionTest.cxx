@@ -0,0 +1,96 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkSCIFIOTestHelpers.h"
+#include "itkImageFileReader.h"
+#include "itkImage.h"
+
+int
+itkSCIFIOImageIOResolutionTest(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " size resolutionCount\n";
+    return EXIT_FAILURE;
+  }
+  const unsigned int size = atoi(argv[1]);
+  const int          resolutionCount = atoi(argv[2]);
+
+  // each level is half the size of the previous one
+  const std::string id = itk::SCIFIOTest::MakeFakeFileName(
+    "pyramid", { { "sizeX", argv[1] }, { "sizeY", argv[1] }, { "resolutions", argv[2] } });
+
+  using ImageType = itk::Image<unsigned char, 2>;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+
+  try
+  {
+    itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+    if (!io->HasBridgeCapability("resolutions"))
+    {
+      std::cout << "The bridge does not expose resolution levels" << std::endl;
+      return itk::SCIFIOTest::SkipReturnCode;
+    }
+    io->SetFileName(id);
+    io->ReadImageInformation();
+
+    const int actualCount = io->GetResolutionCount();
+    std::cout << "Resolution levels: " << actualCount << std::endl;
+    if (actualCount != resolutionCount)
+    {
+      std::cerr << "[ERROR] expected " << resolutionCount << " resolution levels" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (io->SetResolutionLevel(resolutionCount))
+    {
+      std::cerr << "[ERROR] selected a level that does not exist" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    for (int level = resolutionCount - 1; level >= 0; --level)
+    {
+      if (!io->SetResolutionLevel(level))
+      {
+        std::cerr << "[ERROR] could not select level " << level << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      ReaderType::Pointer reader = ReaderType::New();
+      reader->SetImageIO(io);
+      reader->SetFileName(id);
+      reader->Update();
+
+      const ImageType::SizeType actualSize = reader->GetOutput()->GetLargestPossibleRegion().GetSize();
+      const unsigned int        expectedSize = size >> level;
+      std::cout << "Level " << level << ": " << actualSize << ", spacing " << reader->GetOutput()->GetSpacing()
+                << std::endl;
+      if (actualSize[0] != expectedSize || actualSize[1] != expectedSize)
+      {
+        std::cerr << "[ERROR] expected " << expectedSize << " pixels along X and Y" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,88 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkSCIFIOTestHelpers.h"
+
+int
+itkSCIFIOImageIOSeriesTableTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " seriesCount\n";
+    return EXIT_FAILURE;
+  }
+  const int seriesCount = atoi(argv[1]);
+
+  const std::string id = itk::SCIFIOTest::MakeFakeFileName(
+    "plate", { { "sizeX", "64" }, { "sizeY", "48" }, { "sizeZ", "3" }, { "series", argv[1] } });
+
+  try
+  {
+    itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+    io->SetFileName(id);
+
+    itk::TimeProbe probe;
+    probe.Start();
+    const std::vector<itk::SCIFIOCoreMetaData> & table = io->GetSeriesTable();
+    probe.Stop();
+    std::cout << "Read the metadata of " << table.size() << " series in " << probe.GetTotal() << " s" << std::endl;
+
+    if (static_cast<int>(table.size()) != seriesCount || io->GetSeriesCount() != seriesCount)
+    {
+      std::cerr << "[ERROR] expected " << seriesCount << " series" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (io->SetSeries(seriesCount))
+    {
+      std::cerr << "[ERROR] selected a series that does not exist" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // the table agrees with what each series reports on its own
+    for (int series = seriesCount - 1; series >= 0; --series)
+    {
+      const itk::SCIFIOCoreMetaData & core = table[series];
+      if (core.SizeX != 64 || core.SizeY != 48 || core.SizeZ != 3 || core.PixelType != 1)
+      {
+        std::cerr << "[ERROR] series " << series << " is " << core.SizeX << "x" << core.SizeY << "x" << core.SizeZ
+                  << " of pixel type " << core.PixelType << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      if (!io->SetSeries(series))
+      {
+        std::cerr << "[ERROR] could not select series " << series << std::endl;
+        return EXIT_FAILURE;
+      }
+      io->ReadImageInformation();
+      if (io->GetNumberOfDimensions() != 3 || io->GetDimensions(0) != core.SizeX ||
+          io->GetDimensions(1) != core.SizeY || io->GetDimensions(2) != core.SizeZ)
+      {
+        std::cerr << "[ERROR] series " << series << " does not match its table entry" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImage.h"
+
+int
+itkSCIFIOImageIOStatisticsTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " input\n";
+    return EXIT_FAILURE;
+  }
+  const char * fileName = argv[1];
+
+  using ImageType = itk::Image<unsigned char, 2>;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+
+  try
+  {
+    const itk::SCIFIOBridgeStatistics before = itk::SCIFIOBridgeStatistics::GetProcessTotals();
+
+    itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+    io->UseMetaDataCacheOff();
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetImageIO(io);
+    reader->SetFileName(fileName);
+    reader->Update();
+
+    const itk::SCIFIOBridgeStatistics statistics = io->GetBridgeStatistics();
+    statistics.Print(std::cout);
+
+    // the information and the pixels were asked for
+    const auto info = statistics.Commands.find("info");
+    if (info == statistics.Commands.end() || info->second.Count != 1)
+    {
+      std::cerr << "[ERROR] expected a single info command" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (statistics.Commands.count("read") == 0 && statistics.Commands.count("readShm") == 0)
+    {
+      std::cerr << "[ERROR] no read command recorded" << std::endl;
+      return EXIT_FAILURE;
+    }
+    const unsigned long long pixelBytes = reader->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels();
+    if (statistics.BytesReceived + statistics.SharedMemoryBytes < pixelBytes)
+    {
+      std::cerr << "[ERROR] only " << statistics.BytesReceived + statistics.SharedMemoryBytes
+                << " bytes transferred for " << pixelBytes << " bytes of pixels" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (statistics.BytesSent == 0 || statistics.ChunksReceived == 0)
+    {
+      std::cerr << "[ERROR] no pipe traffic recorded" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // the process totals include this instance
+    const itk::SCIFIOBridgeStatistics after = itk::SCIFIOBridgeStatistics::GetProcessTotals();
+    if (after.BytesReceived - before.BytesReceived < statistics.BytesReceived ||
+        after.BytesSent - before.BytesSent < statistics.BytesSent)
+    {
+      std::cerr << "[ERROR] the process totals miss the transfers of the instance" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    io->ResetBridgeStatistics();
+    if (!io->GetBridgeStatistics().Commands.empty() || io->GetBridgeStatistics().BytesReceived != 0)
+    {
+      std::cerr << "[ERROR] the statistics were not reset" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+#ifndef _WIN32
+    // through the pipe, the pixels are read straight into the output
+    io->UseSharedMemoryOff();
+    reader->Modified();
+    reader->Update();
+    if (io->GetBridgeStatistics().BytesReceivedInPlace == 0)
+    {
+      std::cerr << "[ERROR] no bytes read straight into the output" << std::endl;
+      return EXIT_FAILURE;
+    }
+#endif
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -105,7 +105,7 @@ RunTest(const char * inputFileName,
 
   if (allSeries)
   {
-    seriesEnd = io->GetSeriesCount();
+    seriesEnd = static_cast<int>(io->GetSeriesTable().size());
   }
 
   bool insertSeries = seriesEnd > (seriesStart + 1);
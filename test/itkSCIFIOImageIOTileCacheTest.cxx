@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkSCIFIOTileCache.h"
+#include "itkSCIFIOTestHelpers.h"
+#include "itkImageFileReader.h"
+#include "itkImage.h"
+
+namespace
+{
+using PixelType = unsigned short;
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<PixelType, Dimension>;
+using ReaderType = itk::ImageFileReader<ImageType>;
+} // namespace
+
+
+int
+itkSCIFIOImageIOTileCacheTest(int, char *[])
+{
+  const std::string id = itk::SCIFIOTest::MakeFakeFileName(
+    "tileCache", { { "pixelType", "uint16" }, { "sizeX", "700" }, { "sizeY", "600" }, { "sizeZ", "4" } });
+
+  try
+  {
+    ReaderType::Pointer fullReader = ReaderType::New();
+    fullReader->SetImageIO(itk::SCIFIOImageIO::New());
+    fullReader->SetFileName(id);
+    fullReader->Update();
+    ImageType::Pointer full = fullReader->GetOutput();
+
+    itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+    io->SetTileCacheSize(64 * 1024 * 1024);
+    io->SetTileCacheTileSize(128);
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetImageIO(io);
+    reader->SetFileName(id);
+    reader->UpdateOutputInformation();
+
+    // overlapping patches, then the same ones again
+    const long patches[][6] = {
+      { 10, 20, 1, 200, 150, 1 }, { 100, 100, 1, 200, 150, 2 }, { 0, 0, 0, 700, 600, 1 }, { 650, 550, 3, 50, 50, 1 }
+    };
+    for (unsigned int pass = 0; pass < 2; ++pass)
+    {
+      for (const auto & patch : patches)
+      {
+        ImageType::RegionType region;
+        for (unsigned int d = 0; d < Dimension; ++d)
+        {
+          region.SetIndex(d, patch[d]);
+          region.SetSize(d, patch[Dimension + d]);
+        }
+        reader->GetOutput()->SetRequestedRegion(region);
+        reader->Update();
+
+        if (!itk::SCIFIOTest::HaveSamePixels(full.GetPointer(), reader->GetOutput(), region))
+        {
+          std::cerr << "[ERROR] in patch " << region << std::endl;
+          return EXIT_FAILURE;
+        }
+        reader->Modified();
+      }
+    }
+
+    std::cout << "Tile cache: " << io->GetTileCacheHits() << " hits, " << io->GetTileCacheMisses() << " misses"
+              << std::endl;
+    if (io->GetTileCacheHits() == 0 || io->GetTileCacheMisses() == 0)
+    {
+      std::cerr << "[ERROR] expected both hits and misses" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // the planes of a tile are read together, with one read command per
+    // rectangle of the grid, and not again
+    itk::SCIFIOImageIO::Pointer stackIO = itk::SCIFIOImageIO::New();
+    stackIO->SetTileCacheSize(64 * 1024 * 1024);
+    stackIO->SetTileCacheTileSize(128);
+    stackIO->UseSharedMemoryOff();
+    stackIO->SetFileName(id);
+    stackIO->ReadImageInformation();
+    itk::ImageIORegion stack(Dimension);
+    stack.SetSize(0, 256);
+    stack.SetSize(1, 256);
+    stack.SetSize(2, 4);
+    stackIO->SetIORegion(stack);
+    std::vector<PixelType> buffer(stack.GetNumberOfPixels());
+    for (unsigned int pass = 0; pass < 2; ++pass)
+    {
+      stackIO->Read(buffer.data());
+    }
+    const auto commands = stackIO->GetBridgeStatistics().Commands;
+    const auto read = commands.find("read");
+    if (read == commands.end() || read->second.Count != 4)
+    {
+      std::cerr << "[ERROR] expected 4 read commands for 2x2 tiles of 4 planes, got "
+                << (read == commands.end() ? 0 : read->second.Count) << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // the tiles of a file are not found once it is modified
+    itk::SCIFIOTileCache             cache;
+    itk::SCIFIOTileCache::KeyType    key{ "modified.tif", "4\n1000.0\n7", 0, 0, { 0, 0, 0 } };
+    itk::SCIFIOTileCache::BufferType tile(16);
+    cache.SetMaximumSize(1024);
+    cache.Insert(key, std::move(tile));
+    key.FileStamp = "4\n1000.5\n7";
+    if (cache.Find(key) != nullptr)
+    {
+      std::cerr << "[ERROR] found a tile of the file before it was modified" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
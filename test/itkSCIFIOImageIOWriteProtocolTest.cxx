@@ -0,0 +1,191 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkTimeProbe.h"
+
+namespace
+{
+using PixelType = unsigned short;
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<PixelType, Dimension>;
+
+const char * const handshakeProtocol = "per-chunk handshake";
+const char * const streamedProtocol = "streamed planes";
+const char * const sharedMemoryProtocol = "shared memory";
+const char * const binaryProtocol = "binary frames";
+
+struct WriteResult
+{
+  double      Seconds;
+  std::string Protocol;
+};
+
+/*
+ * Writes the image with the SCIFIOImageIO, using the given write protocol
+ * if the bridge supports it, and returns the time it took in seconds and
+ * the protocol actually used, as told by the commands sent.
+ */
+WriteResult
+WriteImage(ImageType * image, const char * fileName, bool useSharedMemory, bool useStreamedWrite)
+{
+  itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+  io->SetUseSharedMemory(useSharedMemory);
+  io->SetUseStreamedWrite(useStreamedWrite);
+
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(io);
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+
+  itk::TimeProbe probe;
+  probe.Start();
+  writer->Update();
+  probe.Stop();
+
+  WriteResult                                       result{ probe.GetTotal(), handshakeProtocol };
+  const itk::SCIFIOBridgeStatistics::CommandMapType commands = io->GetBridgeStatistics().Commands;
+  if (commands.count("writeShm") > 0)
+  {
+    result.Protocol = sharedMemoryProtocol;
+  }
+  else if (commands.count("writeStream") > 0)
+  {
+    result.Protocol = streamedProtocol;
+  }
+  else if (io->HasBridgeCapability("binary"))
+  {
+    result.Protocol = binaryProtocol;
+  }
+  return result;
+}
+
+/*
+ * Reads the file back and checks that it holds the expected pixels.
+ */
+bool
+CheckImage(ImageType * expected, const char * fileName)
+{
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO(itk::SCIFIOImageIO::New());
+  reader->SetFileName(fileName);
+  reader->Update();
+
+  if (reader->GetOutput()->GetLargestPossibleRegion() != expected->GetLargestPossibleRegion())
+  {
+    std::cerr << "[ERROR] " << fileName << " has region " << reader->GetOutput()->GetLargestPossibleRegion()
+              << " expected " << expected->GetLargestPossibleRegion() << std::endl;
+    return false;
+  }
+
+  itk::ImageRegionConstIterator<ImageType> expectedIt(expected, expected->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ImageType> actualIt(reader->GetOutput(), expected->GetLargestPossibleRegion());
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+  {
+    if (expectedIt.Get() != actualIt.Get())
+    {
+      std::cerr << "[ERROR] " << fileName << " differs at " << expectedIt.GetIndex() << ": expected "
+                << expectedIt.Get() << " actual " << actualIt.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+
+int
+itkSCIFIOImageIOWriteProtocolTest(int argc, char * argv[])
+{
+  if (argc < 4)
+  {
+    std::cerr << "Usage: " << argv[0] << " handshakeOutput streamedOutput sharedMemoryOutput [sizeX sizeY sizeZ]\n";
+    return EXIT_FAILURE;
+  }
+
+  // a large synthetic image, so that the protocol overhead shows
+  ImageType::SizeType size;
+  size[0] = 1024;
+  size[1] = 1024;
+  size[2] = 16;
+  for (unsigned int i = 0; i < Dimension && 4 + i < static_cast<unsigned int>(argc); ++i)
+  {
+    size[i] = atoi(argv[4 + i]);
+  }
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(ImageType::RegionType(size));
+  image->Allocate();
+  itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion());
+  PixelType                           value = 0;
+  for (; !it.IsAtEnd(); ++it)
+  {
+    it.Set(value);
+    value = static_cast<PixelType>(value * 31 + 7);
+  }
+
+  try
+  {
+    itk::SCIFIOImageIO::Pointer probeIO = itk::SCIFIOImageIO::New();
+    std::cout << "Bridge capabilities:";
+    for (const char * capability : { "binary", "streamWrite", "shm" })
+    {
+      std::cout << ' ' << capability << '=' << probeIO->HasBridgeCapability(capability);
+    }
+    std::cout << std::endl;
+
+    const WriteResult results[] = { WriteImage(image, argv[1], false, false),
+                                    WriteImage(image, argv[2], false, true),
+                                    WriteImage(image, argv[3], true, true) };
+    const char *      requested[] = { handshakeProtocol, streamedProtocol, sharedMemoryProtocol };
+
+    // runs that fell back to another protocol, because the bridge lacks
+    // the extension or /dev/shm lacks room, are not timings of the
+    // requested protocol
+    const double megabytes = image->GetLargestPossibleRegion().GetNumberOfPixels() * sizeof(PixelType) / 1048576.0;
+    std::cout << "Wrote " << megabytes << " MB" << std::endl;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      std::cout << '\t' << requested[i] << ": ";
+      if (results[i].Protocol != requested[i])
+      {
+        std::cout << "not compared, used " << results[i].Protocol << " in " << results[i].Seconds << " s" << std::endl;
+        continue;
+      }
+      std::cout << results[i].Seconds << " s (" << megabytes / results[i].Seconds << " MB/s)" << std::endl;
+    }
+
+    if (!CheckImage(image, argv[1]) || !CheckImage(image, argv[2]) || !CheckImage(image, argv[3]))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
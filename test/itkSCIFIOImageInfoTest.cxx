@@ -142,6 +142,17 @@ itkSCIFIOImageInfoTest(int argc, char * argv[])
   assertEquals("sizeT", sizeT, actualSizeT);
   assertEquals("sizeC", sizeC, actualSizeC);
 
+  // the typed core metadata agrees with the dictionary
+  const itk::SCIFIOCoreMetaData & core = io->GetCoreMetaData();
+  assertEquals("core sizeX", sizeX, static_cast<int>(core.SizeX));
+  assertEquals("core sizeY", sizeY, static_cast<int>(core.SizeY));
+  assertEquals("core sizeZ", sizeZ, static_cast<int>(core.SizeZ));
+  assertEquals("core sizeT", sizeT, static_cast<int>(core.SizeT));
+  assertEquals("core sizeC", sizeC, static_cast<int>(core.SizeC));
+  std::string pixelType;
+  itk::ExposeMetaData<std::string>(img->GetMetaDataDictionary(), "PixelType", pixelType);
+  assertEquals("core pixel type", pixelType, std::to_string(core.PixelType));
+
   // TODO: Pass more parameters (e.g., pixelType) to this test class,
   // and assert that the itk::Image structure matches those values.
 
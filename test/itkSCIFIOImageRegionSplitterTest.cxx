@@ -0,0 +1,181 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOImageIO.h"
+#include "itkSCIFIOImageRegionSplitter.h"
+#include "itkSCIFIOTestHelpers.h"
+#include "itkImageFileReader.h"
+#include "itkImage.h"
+#include "itkStreamingImageFilter.h"
+
+namespace
+{
+/*
+ * Splits region, and checks that the pieces tile it exactly, with inner
+ * boundaries on the tile grid.
+ */
+bool
+CheckSplits(const itk::SCIFIOImageRegionSplitter * splitter,
+            const itk::ImageIORegion &             region,
+            unsigned int                           requestedNumber)
+{
+  const unsigned int numberOfSplits = splitter->GetNumberOfSplits(region, requestedNumber);
+  if (numberOfSplits < 1 || numberOfSplits > requestedNumber)
+  {
+    std::cerr << "[ERROR] " << numberOfSplits << " splits for " << requestedNumber << " requested" << std::endl;
+    return false;
+  }
+
+  itk::SizeValueType numberOfPixels = 0;
+  itk::ImageIORegion previous;
+  for (unsigned int i = 0; i < numberOfSplits; ++i)
+  {
+    itk::ImageIORegion piece = region;
+    splitter->GetSplit(i, numberOfSplits, piece);
+    std::cout << "\tpiece " << i << ": " << piece << std::endl;
+    if (piece.GetNumberOfPixels() == 0 || !region.IsInside(piece))
+    {
+      std::cerr << "[ERROR] piece " << i << " is empty or outside of " << region << std::endl;
+      return false;
+    }
+    numberOfPixels += piece.GetNumberOfPixels();
+
+    for (unsigned int d = 0; i > 0 && d < region.GetImageDimension(); ++d)
+    {
+      if (piece.GetIndex(d) == previous.GetIndex(d))
+      {
+        continue;
+      }
+      // the split axis: pieces follow each other, and meet on the grid
+      const itk::SizeValueType tileSize = d == 0 ? splitter->GetTileWidth() : d == 1 ? splitter->GetTileHeight() : 1;
+      if (piece.GetIndex(d) != previous.GetIndex(d) + static_cast<itk::IndexValueType>(previous.GetSize(d)) ||
+          piece.GetIndex(d) % static_cast<itk::IndexValueType>(tileSize) != 0)
+      {
+        std::cerr << "[ERROR] piece " << i << " does not start on a tile boundary" << std::endl;
+        return false;
+      }
+    }
+    previous = piece;
+  }
+
+  if (numberOfPixels != region.GetNumberOfPixels())
+  {
+    std::cerr << "[ERROR] the pieces hold " << numberOfPixels << " pixels, expected " << region.GetNumberOfPixels()
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+
+int
+itkSCIFIOImageRegionSplitterTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " inputFile\n";
+    return EXIT_FAILURE;
+  }
+
+  itk::SCIFIOImageRegionSplitter::Pointer splitter = itk::SCIFIOImageRegionSplitter::New();
+  splitter->SetTileWidth(256);
+  splitter->SetTileHeight(100);
+
+  // a plane, split along Y in rows of tiles
+  itk::ImageIORegion plane(2);
+  plane.SetIndex(0, 10);
+  plane.SetSize(0, 1000);
+  plane.SetIndex(1, 50);
+  plane.SetSize(1, 500);
+  // a single row of tiles, split along X
+  itk::ImageIORegion row(2);
+  row.SetIndex(0, 0);
+  row.SetSize(0, 1000);
+  row.SetIndex(1, 0);
+  row.SetSize(1, 100);
+  // a stack, split along Z
+  itk::ImageIORegion stack(3);
+  stack.SetIndex(0, 0);
+  stack.SetSize(0, 300);
+  stack.SetIndex(1, 0);
+  stack.SetSize(1, 300);
+  stack.SetIndex(2, 0);
+  stack.SetSize(2, 7);
+  for (unsigned int requestedNumber = 1; requestedNumber <= 8; ++requestedNumber)
+  {
+    std::cout << requestedNumber << " splits requested" << std::endl;
+    if (!CheckSplits(splitter, plane, requestedNumber) || !CheckSplits(splitter, row, requestedNumber) ||
+        !CheckSplits(splitter, stack, requestedNumber))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // a region within a single tile is not split
+  itk::ImageIORegion tile(2);
+  tile.SetIndex(0, 300);
+  tile.SetSize(0, 200);
+  tile.SetIndex(1, 210);
+  tile.SetSize(1, 80);
+  if (splitter->GetNumberOfSplits(tile, 4) != 1)
+  {
+    std::cerr << "[ERROR] a region within a tile was split" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // a real file, streamed in pieces cut by the splitter of its ImageIO
+  try
+  {
+    using ImageType = itk::Image<unsigned char, 2>;
+    using ReaderType = itk::ImageFileReader<ImageType>;
+    ReaderType::Pointer wholeReader = ReaderType::New();
+    wholeReader->SetImageIO(itk::SCIFIOImageIO::New());
+    wholeReader->SetFileName(argv[1]);
+    wholeReader->Update();
+
+    itk::SCIFIOImageIO::Pointer io = itk::SCIFIOImageIO::New();
+    ReaderType::Pointer         reader = ReaderType::New();
+    reader->SetImageIO(io);
+    reader->SetFileName(argv[1]);
+    using StreamingFilter = itk::StreamingImageFilter<ImageType, ImageType>;
+    StreamingFilter::Pointer streamer = StreamingFilter::New();
+    streamer->SetInput(reader->GetOutput());
+    streamer->SetNumberOfStreamDivisions(4);
+    streamer->SetRegionSplitter(io->GetModifiableRegionSplitter());
+    streamer->Update();
+    std::cout << "Optimal tile size: " << io->GetOptimalTileWidth() << "x" << io->GetOptimalTileHeight() << std::endl;
+
+    if (io->GetRegionSplitter()->GetTileWidth() != io->GetOptimalTileWidth() ||
+        io->GetRegionSplitter()->GetTileHeight() != io->GetOptimalTileHeight())
+    {
+      std::cerr << "[ERROR] the splitter is not on the tiles of the file" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!itk::SCIFIOTest::HaveSamePixels(wholeReader->GetOutput(), streamer->GetOutput()))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,196 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOPixelConversion.h"
+#include "itkSCIFIOByteSwap.h"
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace
+{
+using IOComponentEnum = itk::ImageIOBase::IOComponentEnum;
+
+// Convert values of TSource to TDestination, with their bytes in either
+// order, and check them against static_cast
+template <typename TSource, typename TDestination>
+bool
+CheckPair(IOComponentEnum sourceType, IOComponentEnum destinationType)
+{
+  // negative values only where static_cast keeps them meaningful
+  const bool negative = std::numeric_limits<TSource>::is_signed && std::numeric_limits<TDestination>::is_signed;
+
+  // lengths around the vector sizes, so that the scalar tails are covered
+  for (const size_t count : { 0, 1, 7, 15, 16, 17, 33, 5000 })
+  {
+    std::vector<TSource>      source(count);
+    std::vector<TDestination> expected(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      const int value = static_cast<int>(i % 101) - (negative ? 50 : 0);
+      source[i] = static_cast<TSource>(value);
+      expected[i] = static_cast<TDestination>(source[i]);
+    }
+
+    for (const bool swap : { false, true })
+    {
+      std::vector<TSource> shipped(source);
+      if (swap)
+      {
+        itk::SCIFIOByteSwap::SwapRange(shipped.data(), sizeof(TSource), count);
+      }
+      const std::vector<TSource> before(shipped);
+
+      std::vector<TDestination> destination(count);
+      itk::SCIFIOPixelConversion::Convert(
+        destination.data(), destinationType, shipped.data(), sourceType, count, swap && sizeof(TSource) > 1);
+      if (destination != expected)
+      {
+        std::cerr << "[ERROR] wrong conversion of " << count << ' '
+                  << itk::ImageIOBase::GetComponentTypeAsString(sourceType) << " values to "
+                  << itk::ImageIOBase::GetComponentTypeAsString(destinationType) << (swap ? ", swapped" : "")
+                  << std::endl;
+        return false;
+      }
+      if (shipped != before)
+      {
+        std::cerr << "[ERROR] the conversion changed its source" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename TSource>
+bool
+CheckSource(IOComponentEnum sourceType)
+{
+  return CheckPair<TSource, char>(sourceType, IOComponentEnum::CHAR) &&
+         CheckPair<TSource, unsigned char>(sourceType, IOComponentEnum::UCHAR) &&
+         CheckPair<TSource, short>(sourceType, IOComponentEnum::SHORT) &&
+         CheckPair<TSource, unsigned short>(sourceType, IOComponentEnum::USHORT) &&
+         CheckPair<TSource, int>(sourceType, IOComponentEnum::INT) &&
+         CheckPair<TSource, unsigned int>(sourceType, IOComponentEnum::UINT) &&
+         CheckPair<TSource, long long>(sourceType, IOComponentEnum::LONGLONG) &&
+         CheckPair<TSource, unsigned long long>(sourceType, IOComponentEnum::ULONGLONG) &&
+         CheckPair<TSource, float>(sourceType, IOComponentEnum::FLOAT) &&
+         CheckPair<TSource, double>(sourceType, IOComponentEnum::DOUBLE);
+}
+
+// Interleave planes of TSource channels into TDestination pixels, with
+// their bytes in either order, and check them against static_cast
+template <typename TSource, typename TDestination>
+bool
+CheckPlanar(IOComponentEnum sourceType, IOComponentEnum destinationType)
+{
+  // the shuffled channel counts and another one, and plane sizes around
+  // the vector and block sizes
+  for (const unsigned int channels : { 2, 3, 4, 5 })
+  {
+    for (const size_t pixels : { 0, 1, 15, 16, 17, 1000, 5000 })
+    {
+      std::vector<TSource>      source(channels * pixels);
+      std::vector<TDestination> expected(channels * pixels);
+      for (unsigned int c = 0; c < channels; ++c)
+      {
+        for (size_t p = 0; p < pixels; ++p)
+        {
+          source[c * pixels + p] = static_cast<TSource>((p * 7 + c * 31) % 113);
+          expected[p * channels + c] = static_cast<TDestination>(source[c * pixels + p]);
+        }
+      }
+
+      for (const bool swap : { false, true })
+      {
+        std::vector<TSource> shipped(source);
+        if (swap)
+        {
+          itk::SCIFIOByteSwap::SwapRange(shipped.data(), sizeof(TSource), shipped.size());
+        }
+
+        std::vector<TDestination> destination(channels * pixels);
+        itk::SCIFIOPixelConversion::ConvertPlanar(destination.data(),
+                                                  destinationType,
+                                                  shipped.data(),
+                                                  sourceType,
+                                                  channels,
+                                                  pixels,
+                                                  swap && sizeof(TSource) > 1);
+        if (destination != expected)
+        {
+          std::cerr << "[ERROR] wrong interleaving of " << channels << " planes of " << pixels << ' '
+                    << itk::ImageIOBase::GetComponentTypeAsString(sourceType) << " values into "
+                    << itk::ImageIOBase::GetComponentTypeAsString(destinationType) << (swap ? ", swapped" : "")
+                    << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkSCIFIOPixelConversionTest(int, char *[])
+{
+  using InstructionSetEnum = itk::SCIFIOByteSwap::InstructionSetEnum;
+  const InstructionSetEnum best = itk::SCIFIOByteSwap::GetInstructionSet();
+
+  // with and without the vectorized conversions
+  for (const InstructionSetEnum instructionSet : { best, InstructionSetEnum::SCALAR })
+  {
+    itk::SCIFIOByteSwap::SetInstructionSet(instructionSet);
+    std::cout << "Instruction set " << static_cast<int>(instructionSet) << std::endl;
+
+    // the component types of the bridge, to and from each other
+    if (!CheckSource<char>(IOComponentEnum::CHAR) || !CheckSource<unsigned char>(IOComponentEnum::UCHAR) ||
+        !CheckSource<short>(IOComponentEnum::SHORT) || !CheckSource<unsigned short>(IOComponentEnum::USHORT) ||
+        !CheckSource<int>(IOComponentEnum::INT) || !CheckSource<unsigned int>(IOComponentEnum::UINT) ||
+        !CheckSource<long long>(IOComponentEnum::LONGLONG) ||
+        !CheckSource<unsigned long long>(IOComponentEnum::ULONGLONG) ||
+        !CheckSource<float>(IOComponentEnum::FLOAT) || !CheckSource<double>(IOComponentEnum::DOUBLE))
+    {
+      itk::SCIFIOByteSwap::SetInstructionSet(best);
+      return EXIT_FAILURE;
+    }
+
+    // planar channels of every component size, as is and converted
+    if (!CheckPlanar<unsigned char, unsigned char>(IOComponentEnum::UCHAR, IOComponentEnum::UCHAR) ||
+        !CheckPlanar<unsigned short, unsigned short>(IOComponentEnum::USHORT, IOComponentEnum::USHORT) ||
+        !CheckPlanar<float, float>(IOComponentEnum::FLOAT, IOComponentEnum::FLOAT) ||
+        !CheckPlanar<double, double>(IOComponentEnum::DOUBLE, IOComponentEnum::DOUBLE) ||
+        !CheckPlanar<long long, long long>(IOComponentEnum::LONGLONG, IOComponentEnum::LONGLONG) ||
+        !CheckPlanar<unsigned char, unsigned short>(IOComponentEnum::UCHAR, IOComponentEnum::USHORT) ||
+        !CheckPlanar<unsigned short, float>(IOComponentEnum::USHORT, IOComponentEnum::FLOAT))
+    {
+      itk::SCIFIOByteSwap::SetInstructionSet(best);
+      return EXIT_FAILURE;
+    }
+  }
+  itk::SCIFIOByteSwap::SetInstructionSet(best);
+
+  if (itk::SCIFIOPixelConversion::IsSupported(IOComponentEnum::UNKNOWNCOMPONENTTYPE, IOComponentEnum::FLOAT))
+  {
+    std::cerr << "[ERROR] claims to convert from an unknown component type" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
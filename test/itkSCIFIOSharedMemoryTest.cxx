@@ -0,0 +1,106 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSCIFIOSharedMemory.h"
+#include "itkMacro.h"
+#include "itksys/SystemTools.hxx"
+
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#  include <csignal>
+#  include <sys/resource.h>
+#endif
+
+/*
+ * Creates shared memory segments and touches all of their pages. Then
+ * creates one larger than the files this process may write, as a stand-in
+ * for a /dev/shm too small for it, and checks that the constructor throws
+ * rather than the process being killed once the memory is written:
+ * SCIFIOImageIO relies on the exception to fall back to the pipes, on reads
+ * as well as on writes.
+ */
+int
+itkSCIFIOSharedMemoryTest(int, char *[])
+{
+  if (!itk::SCIFIOSharedMemory::IsSupported())
+  {
+    std::cout << "Shared memory is not supported on this system" << std::endl;
+    try
+    {
+      itk::SCIFIOSharedMemory sharedMemory(1024);
+      std::cerr << "[ERROR] created an unsupported segment" << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch (itk::ExceptionObject &)
+    {
+      return EXIT_SUCCESS;
+    }
+  }
+
+#ifndef _WIN32
+  for (const size_t size : { size_t{ 0 }, size_t{ 1 }, size_t{ 4096 }, size_t{ 16 } << 20 })
+  {
+    itk::SCIFIOSharedMemory sharedMemory(size);
+    if (sharedMemory.GetSize() < size || !itksys::SystemTools::FileExists(sharedMemory.GetPath(), true))
+    {
+      std::cerr << "[ERROR] wrong segment of " << size << " bytes" << std::endl;
+      return EXIT_FAILURE;
+    }
+    memset(sharedMemory.GetBuffer(), 0x5a, sharedMemory.GetSize());
+  }
+
+  // files beyond the limit fail with EFBIG once SIGXFSZ is ignored
+  struct rlimit original;
+  getrlimit(RLIMIT_FSIZE, &original);
+  struct rlimit limited = original;
+  limited.rlim_cur = 1 << 20;
+  if (original.rlim_cur != RLIM_INFINITY && original.rlim_cur < limited.rlim_cur)
+  {
+    limited.rlim_cur = original.rlim_cur;
+  }
+  signal(SIGXFSZ, SIG_IGN);
+  if (setrlimit(RLIMIT_FSIZE, &limited) != 0)
+  {
+    std::cerr << "[ERROR] cannot limit the file size" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  bool thrown = false;
+  try
+  {
+    itk::SCIFIOSharedMemory sharedMemory(static_cast<size_t>(limited.rlim_cur) * 16);
+    memset(sharedMemory.GetBuffer(), 0x5a, sharedMemory.GetSize());
+  }
+  catch (itk::ExceptionObject & e)
+  {
+    std::cout << "Expected: " << e.GetDescription() << std::endl;
+    thrown = true;
+  }
+  setrlimit(RLIMIT_FSIZE, &original);
+  signal(SIGXFSZ, SIG_DFL);
+
+  if (!thrown)
+  {
+    std::cerr << "[ERROR] created a segment larger than the file system allows" << std::endl;
+    return EXIT_FAILURE;
+  }
+#endif
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSCIFIOTestHelpers_h
+#define itkSCIFIOTestHelpers_h
+
+#include "itkImageRegionConstIterator.h"
+#include "itkNumericTraits.h"
+#include "itkTimeProbe.h"
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+namespace SCIFIOTest
+{
+/** SKIP_RETURN_CODE of the tests that need a bridge capability. */
+constexpr int SkipReturnCode = 77;
+
+using FakePropertiesType = std::vector<std::pair<std::string, std::string>>;
+
+/** Name of a synthetic image, such as "plate&sizeX=64&series=24.fake".
+ * SCIFIO synthesizes .fake files from the properties in their name, so
+ * they do not need to exist. */
+inline std::string
+MakeFakeFileName(const std::string & name, const FakePropertiesType & properties)
+{
+  std::string fileName = name;
+  for (const auto & property : properties)
+  {
+    fileName += '&' + property.first + '=' + property.second;
+  }
+  return fileName + ".fake";
+}
+
+/** Seconds taken by the Update() of a reader or filter. */
+template <typename TProcess>
+double
+TimeUpdate(TProcess * process)
+{
+  TimeProbe probe;
+  probe.Start();
+  process->Update();
+  probe.Stop();
+  return probe.GetTotal();
+}
+
+/** Whether both images hold the same pixels in the region, printing the
+ * first difference. */
+template <typename TImage>
+bool
+HaveSamePixels(const TImage * expected, const TImage * actual, const typename TImage::RegionType & region)
+{
+  using PrintType = typename NumericTraits<typename TImage::PixelType>::PrintType;
+  ImageRegionConstIterator<TImage> expectedIt(expected, region);
+  ImageRegionConstIterator<TImage> actualIt(actual, region);
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+  {
+    if (expectedIt.Get() != actualIt.Get())
+    {
+      std::cerr << "[ERROR] images differ at " << expectedIt.GetIndex() << ": expected "
+                << static_cast<PrintType>(expectedIt.Get()) << " actual " << static_cast<PrintType>(actualIt.Get())
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/** Whether both images have the same largest possible region, and the
+ * same pixels in it. */
+template <typename TImage>
+bool
+HaveSamePixels(const TImage * expected, const TImage * actual)
+{
+  if (expected->GetLargestPossibleRegion() != actual->GetLargestPossibleRegion())
+  {
+    std::cerr << "[ERROR] regions differ: " << expected->GetLargestPossibleRegion() << " vs "
+              << actual->GetLargestPossibleRegion() << std::endl;
+    return false;
+  }
+  return HaveSamePixels(expected, actual, expected->GetLargestPossibleRegion());
+}
+} // end namespace SCIFIOTest
+} // end namespace itk
+
+#endif // itkSCIFIOTestHelpers_h